@@ -0,0 +1,111 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace duckdb {
+
+// =============================================================================
+// PathVariableDiskCache
+// =============================================================================
+//
+// Local disk tier for remote pathvariable: targets (cache modifier):
+//
+//   SELECT * FROM read_parquet('pathvariable:cache:ref_data');
+//
+// Every remote file (s3://, https://, ...) the path resolves to is copied
+// into pathvariable_cache_directory once, and the local copy is read in its
+// place. Glob hands remote files out as pathvariable:cached:<remote path>, so
+// the listing keeps their names (and hive keys) and nothing is downloaded
+// until a file is opened. Local targets and scalarfs paths are left alone.
+//
+// Cache files are keyed by the remote path, its size and its version (last
+// modified time and ETag), so a rewritten object gets a new cache file rather
+// than serving stale bytes. Looking up the version costs one open (a HEAD
+// request for httpfs) per file and query.
+//
+// Size budget: pathvariable_cache_max_size bytes (0 disables the cache).
+// Least recently used files are evicted to make room, except files used in
+// the last EVICTION_GRACE_SECONDS - they may belong to a scan in progress.
+// A file that does not fit is read remotely instead. Files from earlier
+// sessions are picked up on first use, ordered by their modification time.
+//
+// Management:
+//   SELECT * FROM pathvariable_disk_cache();     -- list cached files
+//   SELECT pathvariable_clear_disk_cache();      -- delete them
+//
+
+class PathVariableDiskCache {
+public:
+	static constexpr const char *DIRECTORY_SETTING = "pathvariable_cache_directory";
+	static constexpr const char *MAX_SIZE_SETTING = "pathvariable_cache_max_size";
+	static constexpr uint64_t DEFAULT_MAX_SIZE = 4ULL * 1024 * 1024 * 1024;
+	static constexpr int64_t EVICTION_GRACE_SECONDS = 300;
+	static constexpr idx_t COPY_BUFFER_SIZE = 1024 * 1024;
+
+	struct EntryInfo {
+		string cache_file;
+		// Remote path, empty for files found from an earlier session
+		string source_path;
+		idx_t size;
+		timestamp_t last_access;
+	};
+
+	// Return a local copy of a remote path, downloading it if needed. Returns
+	// the path unchanged if it is not remote or cannot be cached (too large,
+	// unknown version, already being downloaded, or the download failed).
+	string Materialize(ClientContext &context, FileSystem &fs, const string &path);
+
+	// Cached files in the current cache directory
+	vector<EntryInfo> GetEntries(ClientContext &context, FileSystem &fs);
+
+	// Delete all cached files, returning how many were removed
+	idx_t Clear(ClientContext &context, FileSystem &fs);
+
+	// Whether a path is read from a remote filesystem
+	static bool IsRemotePath(const string &path);
+
+	// pathvariable:cached:<path> - opening it reads the local copy of path
+	static string GetCachedPath(const string &path);
+	static bool IsCachedPath(const string &path);
+	// The remote path of a cached path; false if it is not one
+	static bool ParseCachedPath(const string &path, string &target);
+
+	// Register the settings, pathvariable_disk_cache() and pathvariable_clear_disk_cache()
+	static void Register(ExtensionLoader &loader, shared_ptr<PathVariableDiskCache> disk_cache);
+
+private:
+	struct Entry {
+		string source_path;
+		idx_t size;
+		timestamp_t last_access;
+	};
+
+	static string GetDirectory(ClientContext &context, FileSystem &fs);
+	static uint64_t GetMaxSize(ClientContext &context);
+	// Cache file name for a remote file version
+	static string GetCacheFileName(const string &path, idx_t size, timestamp_t last_modified, const string &etag);
+
+	// Switch to (and index) a cache directory; requires lock
+	void LoadDirectory(FileSystem &fs, const string &cache_directory);
+	// Evict least recently used files until needed bytes fit; requires lock
+	bool Reserve(FileSystem &fs, idx_t needed, idx_t max_size);
+
+	std::mutex lock;
+	string directory;
+	bool loaded = false;
+	// Cached files by local path, and their total size (including reservations
+	// for downloads in progress)
+	std::unordered_map<string, Entry> entries;
+	std::unordered_set<string> downloading;
+	idx_t total_size = 0;
+};
+
+} // namespace duckdb
@@ -4,9 +4,14 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/open_file_info.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "data_uri_filesystem.hpp"
+#include "pathvariable_disk_cache.hpp"
+#include "pathvariable_glob_cache.hpp"
+#include "pathvariable_io_pool.hpp"
 #include "pathvariable_modifiers.hpp"
+#include "pathvariable_prefetch.hpp"
+#include <functional>
 #include <mutex>
-#include <unordered_map>
 
 namespace duckdb {
 
@@ -26,43 +31,216 @@ namespace duckdb {
 //   SELECT * FROM read_csv('pathvariable:my_path');
 //   -- Equivalent to: SELECT * FROM read_csv('/data/input.csv');
 //
+// Path records: a STRUCT with a "path" field (or a list of them, as written by
+// COPY ... TO 'variable:x' (FORMAT variable)) is resolved through that field.
+//
 // Two-level glob support:
 //   Level 1: Glob on variable names (pathvariable:data_* matches data_01, data_02)
 //   Level 2: Glob within paths (if data_01 = '/data/*.csv', expands that glob too)
 //
+// Local disk cache (cache modifier):
+//   pathvariable:cache:ref_data reads remote targets from local copies kept in
+//   pathvariable_cache_directory, downloaded when a file is first opened
+//
+// Sharded writes (shard modifier):
+//   pathvariable:shard:targets is a directory spread over the VARCHAR[] list of
+//   target directories: each file written below it (PER_THREAD_OUTPUT,
+//   FILE_SIZE_BYTES, PARTITION_BY) goes to the next target in round-robin
+//   order, or to the one with the fewest bytes written (shard!least-bytes)
+//
+// Read-ahead (prefetch modifier):
+//   pathvariable:prefetch!k:files reads the next k files of the glob result
+//   into memory in the background while the current one is scanned, from the
+//   first open until the query ends
+//
+// Read capture (capture modifier):
+//   pathvariable:capture!snap:src tees the bytes read from src into a buffer
+//   that becomes variable snap when the query ends (variable:snap)
+//
+// Hedged reads (race modifier):
+//   pathvariable:race:mirrors opens all mirror candidates (race!k: the first k)
+//   concurrently on a bounded pool; the first to open and serve its first
+//   block backs the handle, and the losers are closed in the background
+//
 // Temp file handling (for COPY with USE_TMP_FILE):
 //   tmp_pathvariable:X -> reads variable X, computes temp path, delegates to parent FS
 //   MoveFile handles the temp -> final path transition
 //
 
-class PathVariableFileSystem : public FileSystem {
+// =============================================================================
+// PathVariableShardState
+// =============================================================================
+//
+// Write distribution over one list of shard targets, shared by every file
+// written to it (and kept across statements, so round-robin continues)
+//
+
+struct PathVariableShardState {
+	explicit PathVariableShardState(idx_t target_count)
+	    : bytes_written(target_count, 0), open_files(target_count, 0) {
+	}
+
+	// Pick the target for a new file and count it as open
+	idx_t Assign(PathVariableShardMode mode);
+	void RecordWrite(idx_t target, idx_t bytes);
+	void RecordClose(idx_t target);
+
+	std::mutex lock;
+	idx_t next_target = 0;
+	vector<idx_t> bytes_written;
+	vector<idx_t> open_files;
+};
+
+// =============================================================================
+// PathVariableHandleFileSystem
+// =============================================================================
+//
+// The filesystem of wrapped handles (see PathVariableFileHandle): it forwards
+// every handle operation to the underlying handle and records what the
+// wrapper observes. DuckDB asks FileSystem::CanSeek() of the handle's
+// filesystem, without the handle, so handles over targets that cannot seek
+// (pipes, compressed streams) belong to an instance that answers false. It
+// opens nothing itself and is never registered.
+//
+
+class PathVariableHandleFileSystem : public FileSystem {
 public:
-	// FileSystem interface
-	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags, optional_ptr<FileOpener> opener) override;
+	explicit PathVariableHandleFileSystem(bool can_seek);
 
-	bool CanHandleFile(const string &fpath) override;
 	string GetName() const override;
 
-	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener) override;
-
-	// File operations - all delegate to parent filesystem via the handle
 	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override;
 	int64_t Read(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
 	void Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override;
 	int64_t Write(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
 	int64_t GetFileSize(FileHandle &handle) override;
-	bool FileExists(const string &filename, optional_ptr<FileOpener> opener) override;
 	void Seek(FileHandle &handle, idx_t location) override;
 	idx_t SeekPosition(FileHandle &handle) override;
 	void Reset(FileHandle &handle) override;
 	bool CanSeek() override;
 	bool OnDiskFile(FileHandle &handle) override;
+	void Truncate(FileHandle &handle, int64_t new_size) override;
+	void FileSync(FileHandle &handle) override;
 	timestamp_t GetLastModifiedTime(FileHandle &handle) override;
+	string GetVersionTag(FileHandle &handle) override;
+
+private:
+	bool can_seek;
+};
+
+class PathVariableFileSystem : public FileSystem {
+public:
+	PathVariableFileSystem()
+	    : glob_cache(make_shared_ptr<PathVariableGlobCache>()),
+	      missing_cache(make_shared_ptr<PathVariableMissingCache>()),
+	      disk_cache(make_shared_ptr<PathVariableDiskCache>()), io_pool(make_shared_ptr<PathVariableIOPool>()),
+	      prefetch_used_bytes(make_shared_ptr<std::atomic<idx_t>>(0)) {
+	}
+
+	// Glob result cache, shared with pathvariable_clear_cache()
+	shared_ptr<PathVariableGlobCache> GetGlobCache() const {
+		return glob_cache;
+	}
+
+	// Negative FileExists cache for search/no-missing, shared with pathvariable_clear_cache()
+	shared_ptr<PathVariableMissingCache> GetMissingCache() const {
+		return missing_cache;
+	}
+
+	// Local copies of remote files for the cache modifier, shared with pathvariable_disk_cache()
+	shared_ptr<PathVariableDiskCache> GetDiskCache() const {
+		return disk_cache;
+	}
+
+	// Maximum concurrent filesystem requests per glob (level 2 listings and existence probes)
+	static constexpr const char *IO_PARALLELISM_SETTING = "pathvariable_io_parallelism";
+	static constexpr uint64_t DEFAULT_IO_PARALLELISM = 16;
+	static uint64_t GetIOParallelism(ClientContext &context);
+
+	// Largest file a capture modifier keeps in its variable
+	static constexpr const char *CAPTURE_MAX_SIZE_SETTING = "pathvariable_capture_max_size";
+	static constexpr uint64_t DEFAULT_CAPTURE_MAX_SIZE = 256ULL * 1024 * 1024;
+	static uint64_t GetCaptureMaxSize(ClientContext &context);
+
+	// Run task(0) ... task(count - 1) on the calling thread and up to
+	// max_in_flight - 1 IO pool threads. Rethrows the error of the lowest
+	// failing task; no new tasks start after a failure.
+	void RunConcurrently(idx_t count, idx_t max_in_flight, const std::function<void(idx_t)> &task);
+
+	// IO pool, shared with pathvariable_max_mtime()
+	shared_ptr<PathVariableIOPool> GetIOPool() const {
+		return io_pool;
+	}
+
+	// FileSystem interface
+	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags, optional_ptr<FileOpener> opener) override;
+
+	bool CanHandleFile(const string &fpath) override;
+	string GetName() const override;
+
+	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener) override;
+
+	// Path operations - handles belong to the target's filesystem, or to a
+	// PathVariableHandleFileSystem when wrapped
+	bool FileExists(const string &filename, optional_ptr<FileOpener> opener) override;
+	bool IsPipe(const string &filename, optional_ptr<FileOpener> opener) override;
 	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener) override;
 	bool TryRemoveFile(const string &filename, optional_ptr<FileOpener> opener) override;
 	void MoveFile(const string &source, const string &target, optional_ptr<FileOpener> opener) override;
+	// Directory operations - only shard paths are directories
+	bool DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) override;
+	void CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) override;
+	bool ListFiles(const string &directory, const std::function<void(const string &, bool)> &callback,
+	               FileOpener *opener = nullptr) override;
+
+	static constexpr idx_t MAX_SHARD_STATES = 256;
+
+	// Bytes read from each race candidate before it may win
+	static constexpr idx_t RACE_PROBE_BYTES = 4096;
 
 private:
+	// Run the glob pipeline (levels 1 and 2, modifiers, caching) for a path
+	vector<OpenFileInfo> ExpandPath(const string &path, FileOpener *opener);
+
+	// Open candidates concurrently (race modifier); the first to open and read
+	// its first block wins. Candidates are opened on detached threads (see
+	// PathVariableIOPool::StartDetached), and losing opens are closed there
+	// whenever they complete - neither this call, the returned handle nor
+	// shutdown waits for them.
+	unique_ptr<FileHandle> OpenRace(const string &path, const PathVariablePipeline &pipeline, FileOpenFlags flags,
+	                                optional_ptr<FileOpener> opener);
+
+	// Whether a path uses the shard modifier
+	bool IsShardPath(const string &path);
+
+	// Split a shard path into its target directories (the list variable before
+	// the first separator) and the relative path below them
+	vector<string> GetShardTargets(const string &path, optional_ptr<FileOpener> opener, string &relative);
+
+	// Wrap a handle whose reads or writes are observed (capture, shard). The
+	// wrapper belongs to the handle filesystem matching the handle's seekability.
+	unique_ptr<FileHandle> WrapHandle(const string &path, unique_ptr<FileHandle> handle);
+
+	// Register a prefetch pipeline over a glob result, routing its paths
+	// through the pipeline (pathvariable:prefetched:<path>)
+	void StartPrefetch(const PathVariablePipeline &pipeline, vector<OpenFileInfo> &files, FileOpener *opener);
+
+	// Open the one file a capture path resolves to, teeing its reads into the
+	// capture variable
+	unique_ptr<FileHandle> OpenCapture(const string &path, const PathVariablePipeline &pipeline, FileOpenFlags flags,
+	                                   optional_ptr<FileOpener> opener);
+
+	// Open a file handed out by a prefetch pipeline, from memory if it was fetched
+	unique_ptr<FileHandle> OpenPrefetched(const string &path, FileOpenFlags flags, optional_ptr<FileOpener> opener);
+
+	// Open a file below a shard path: writes go to the assigned target, reads
+	// to the first target that has the file
+	unique_ptr<FileHandle> OpenShard(const string &path, const PathVariablePipeline &pipeline, FileOpenFlags flags,
+	                                 optional_ptr<FileOpener> opener);
+
+	// Distribution state for a list of targets
+	shared_ptr<PathVariableShardState> GetShardState(const vector<string> &targets);
+
 	// Extract variable name from pathvariable: or tmp_pathvariable: path
 	string ExtractVariableName(const string &path);
 
@@ -87,20 +265,68 @@ private:
 	// Check if a variable contains a list type
 	bool IsListVariable(const string &var_name, optional_ptr<FileOpener> opener);
 
+	// Whether values of this type can be used as a path: VARCHAR, BLOB, or a
+	// STRUCT with a VARCHAR/BLOB "path" field (a path record - other fields are
+	// ignored)
+	static bool IsPathType(const LogicalType &type);
+
+	// The path of a value of a path type; false if it (or its path field) is NULL
+	static bool GetPathFromValue(const Value &value, string &path);
+
+	// The "size" / "file_size" field of a path record, if present
+	static bool GetSizeFromValue(const Value &value, idx_t &size);
+
+	// Whether a path record passes the where! predicates on its fields.
+	// Predicates on fields the record does not have are left to the path.
+	static bool RecordMatches(const vector<PathVariablePredicate> &predicates, const vector<Value> &operands,
+	                          const Value &record);
+
+	// Whether the hive keys (key=value directories) of a path pass the where!
+	// predicates. Predicates on keys the path does not have are not checked.
+	static bool HiveKeysMatch(const vector<PathVariablePredicate> &predicates, const vector<Value> &operands,
+	                          const string &path);
+
+	// The file size a listing attached to the result (extended_info "file_size"), if any
+	static bool GetListedFileSize(const OpenFileInfo &info, idx_t &size);
+
 	// Compute temp path for a given target path (prepend tmp_ to filename)
 	static string ComputeTempPath(const string &target_path);
 
 	// Get the parent filesystem for delegation
 	FileSystem &GetParentFileSystem(optional_ptr<FileOpener> opener);
 
-	// Glob result cache
-	// Key: pathvariable: path string (including modifiers)
-	// Value: vector of resolved OpenFileInfo results
-	mutable std::mutex cache_mutex;
-	mutable std::unordered_map<string, vector<OpenFileInfo>> glob_cache;
+	// Check which candidates exist, with up to max_in_flight probes running
+	// concurrently on the IO pool. With first_only, only the flags up to the first existing
+	// candidate (in order) are meaningful. Candidates in the missing cache are
+	// skipped, and newly found missing ones are recorded for missing_ttl seconds.
+	vector<bool> ProbeFileExists(FileSystem &fs, const vector<OpenFileInfo> &candidates, idx_t max_in_flight,
+	                             bool first_only, uint64_t missing_ttl);
 
-	// Clear the glob cache (for testing or manual invalidation)
-	void ClearCache();
+	// Compiled paths by path string (see pathvariable_modifiers.hpp)
+	PathVariableCompileCache compile_cache;
+
+	// Glob result and negative existence caches (see pathvariable_glob_cache.hpp)
+	shared_ptr<PathVariableGlobCache> glob_cache;
+	shared_ptr<PathVariableMissingCache> missing_cache;
+	// Local disk tier for remote targets (see pathvariable_disk_cache.hpp)
+	shared_ptr<PathVariableDiskCache> disk_cache;
+
+	// Threads for race candidates, prefetch fetches, listings and probes (see pathvariable_io_pool.hpp)
+	shared_ptr<PathVariableIOPool> io_pool;
+
+	// Bytes buffered by the read-ahead pipelines of all connections (see
+	// pathvariable_prefetch.hpp), bounded by pathvariable_prefetch_max_memory
+	shared_ptr<std::atomic<idx_t>> prefetch_used_bytes;
+	// Serves the in-memory handles of prefetched files
+	DataURIFileSystem memory_fs;
+
+	// Shard distribution state by target list
+	std::mutex shard_lock;
+	unordered_map<string, shared_ptr<PathVariableShardState>> shard_states;
+
+	// Back the wrapped handles, over targets that can seek and ones that cannot
+	PathVariableHandleFileSystem seekable_handle_fs {true};
+	PathVariableHandleFileSystem stream_handle_fs {false};
 };
 
 // =============================================================================
@@ -109,17 +335,39 @@ private:
 //
 // A wrapper handle that holds:
 // 1. The underlying file handle from the parent filesystem
-// 2. Reference to the parent filesystem for operations
+// 2. Reference to the filesystem that created it (LocalFileSystem, httpfs, ...)
 //
-// All operations are delegated to the underlying handle's filesystem.
+// The wrapper belongs to a PathVariableHandleFileSystem, which delegates all
+// operations to the underlying handle's own filesystem, resolved once at open,
+// rather than through the virtual filesystem and its client wrapper, which
+// would only dispatch to it again on every read.
 //
+// Only opens that observe the handle (capture reads, shard writes) wrap it;
+// every other open returns the target's own handle, so DuckDB's capability
+// queries (CanSeek, OnDiskFile, ...) reach the filesystem that serves it.
+//
+
+struct PathVariableCapture;
 
 class PathVariableFileHandle : public FileHandle {
 public:
-	PathVariableFileHandle(FileSystem &pathvar_fs, string original_path, unique_ptr<FileHandle> underlying_handle,
-	                       FileSystem &underlying_fs);
+	PathVariableFileHandle(FileSystem &pathvar_fs, string original_path, unique_ptr<FileHandle> underlying_handle);
+	~PathVariableFileHandle() override;
 	void Close() override;
 
+	// Count writes and the close of this handle against its shard target
+	void SetShard(shared_ptr<PathVariableShardState> shard_p, idx_t shard_target_p);
+	void RecordWrite(idx_t bytes);
+
+	// Copy the bytes read into a variable (set when the query ends)
+	void SetCapture(unique_ptr<PathVariableCapture> capture_p);
+	bool IsCapturing() const {
+		return capture != nullptr;
+	}
+	void RecordRead(const void *buffer, idx_t nr_bytes, idx_t location);
+	// One past the furthest byte captured so far
+	idx_t CapturedSize();
+
 	FileHandle &GetUnderlyingHandle() {
 		return *underlying_handle;
 	}
@@ -130,6 +378,9 @@ public:
 private:
 	unique_ptr<FileHandle> underlying_handle;
 	FileSystem &underlying_fs;
+	unique_ptr<PathVariableCapture> capture;
+	shared_ptr<PathVariableShardState> shard;
+	idx_t shard_target = 0;
 };
 
 } // namespace duckdb
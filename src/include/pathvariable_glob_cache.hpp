@@ -0,0 +1,121 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+class PathVariableMissingCache;
+
+// =============================================================================
+// PathVariableGlobCache
+// =============================================================================
+//
+// Caches the result of PathVariableFileSystem::Glob per pathvariable: path
+// string (including modifiers).
+//
+// Every entry records a fingerprint of the variables consulted while
+// resolving it: the level 1 variable names and values, plus variables
+// referenced by modifiers (append!$var, prepend!$var). A lookup whose
+// fingerprint differs - a variable was changed, added or removed - is a miss,
+// so SET VARIABLE never yields stale paths.
+//
+// Results that also depend on the filesystem (level 2 globs, search and
+// no-missing existence checks) can change without any variable changing:
+//   - remote paths (s3://, https://, ...) are cached for
+//     pathvariable_glob_cache_ttl seconds (default 60, 0 disables)
+//   - local paths are never cached - listing them is cheap
+//
+// The no-cache modifier bypasses the cache, and pathvariable_clear_cache()
+// drops all entries (together with the PathVariableMissingCache below).
+//
+
+class PathVariableGlobCache {
+public:
+	static constexpr idx_t MAX_ENTRIES = 1024;
+	static constexpr const char *TTL_SETTING = "pathvariable_glob_cache_ttl";
+	static constexpr uint64_t DEFAULT_TTL_SECONDS = 60;
+
+	// Look up a cached result; false if missing, expired or the fingerprint differs
+	bool Lookup(const string &path, hash_t fingerprint, vector<OpenFileInfo> &result);
+
+	// Store a result. Entries with expires set are dropped after ttl_seconds.
+	void Store(const string &path, hash_t fingerprint, const vector<OpenFileInfo> &result, bool expires,
+	           uint64_t ttl_seconds);
+
+	// Drop all entries, returning how many were removed
+	idx_t Clear();
+
+	// TTL for filesystem-dependent entries, from the current setting
+	static uint64_t GetTTLSeconds(ClientContext &context);
+
+	// Register the TTL settings of both caches and pathvariable_clear_cache()
+	static void Register(ExtensionLoader &loader, shared_ptr<PathVariableGlobCache> glob_cache,
+	                     shared_ptr<PathVariableMissingCache> missing_cache);
+
+private:
+	using steady_clock = std::chrono::steady_clock;
+
+	struct Entry {
+		hash_t fingerprint;
+		vector<OpenFileInfo> result;
+		bool expires;
+		steady_clock::time_point expires_at;
+	};
+
+	std::mutex lock;
+	std::unordered_map<string, Entry> entries;
+};
+
+// =============================================================================
+// PathVariableMissingCache
+// =============================================================================
+//
+// Remembers candidates that search and no-missing found to NOT exist, so
+// search paths that probe the same absent override locations on every query
+// (pathvariable:search:roots with a local override first) skip them.
+//
+// Entries expire after pathvariable_missing_cache_ttl seconds (default 5, 0
+// disables). Writes through pathvariable: (OpenFile for writing, MoveFile)
+// drop the written path right away; files created by other means show up once
+// the entry expires. Only real filesystem paths are cached - scalarfs virtual
+// paths (variable:, data:, ...) are cheap to check and change with SET.
+//
+
+class PathVariableMissingCache {
+public:
+	static constexpr idx_t MAX_ENTRIES = 4096;
+	static constexpr const char *TTL_SETTING = "pathvariable_missing_cache_ttl";
+	static constexpr uint64_t DEFAULT_TTL_SECONDS = 5;
+
+	// Whether the path was recently found missing
+	bool IsKnownMissing(const string &path);
+
+	// Record that the path does not exist (no-op for ttl_seconds == 0)
+	void RecordMissing(const string &path, uint64_t ttl_seconds);
+
+	// Forget a path (it was just written)
+	void Invalidate(const string &path);
+
+	// Drop all entries, returning how many were removed
+	idx_t Clear();
+
+	// Whether existence checks on this path may be cached
+	static bool IsCacheablePath(const string &path);
+
+	static uint64_t GetTTLSeconds(ClientContext &context);
+
+private:
+	using steady_clock = std::chrono::steady_clock;
+
+	std::mutex lock;
+	std::unordered_map<string, steady_clock::time_point> entries;
+};
+
+} // namespace duckdb
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace duckdb {
+
+// =============================================================================
+// PathVariableIOPool
+// =============================================================================
+//
+// Threads for background filesystem requests that may outlive the call that
+// started them: the fetches of a prefetch pipeline, and the opens of a race.
+// Jobs hold shared state rather than references into the caller, so the
+// caller never waits for a job it no longer needs.
+//
+// Run() spreads the requests of a single call (listings, existence probes,
+// stat lookups) over the calling thread and idle pool threads. The calling
+// thread works through the tasks itself, so a call completes even when every
+// pool thread is busy with a slow request.
+//
+// Pool threads are started on demand, up to MAX_THREADS per filesystem; beyond
+// that, jobs queue. Race opens do not queue behind them: StartDetached() gives
+// each race worker a thread of its own, up to MAX_DETACHED_THREADS, so a
+// stalled mirror holds only its own thread.
+//
+// No thread is joined. When the pool goes away, queued jobs are dropped and
+// the threads exit once their current job returns - a request stalled on a
+// mirror does not hold up shutdown.
+//
+
+class PathVariableIOPool {
+public:
+	static constexpr idx_t MAX_THREADS = 32;
+	static constexpr idx_t MAX_DETACHED_THREADS = 32;
+
+	PathVariableIOPool();
+	~PathVariableIOPool();
+
+	// Run a job on a pool thread (inline in builds without threads). Errors a
+	// job throws are swallowed - report them through its shared state.
+	void Submit(std::function<void()> job);
+
+	// Run a job on a thread of its own, for a request that may block for as
+	// long as a remote does. False (and the job is not run) when
+	// MAX_DETACHED_THREADS are running, or in builds without threads.
+	bool StartDetached(std::function<void()> job);
+
+	// Run task(0) ... task(count - 1) in order on the calling thread and up to
+	// max_in_flight - 1 pool threads. No new tasks start once a task returns
+	// false or throws; returns when the tasks started are done, rethrowing the
+	// error of the lowest failing task.
+	void Run(idx_t count, idx_t max_in_flight, const std::function<bool(idx_t)> &task);
+
+private:
+	// Shared with the threads, which may outlive the pool
+	struct Workers;
+	struct RunState;
+
+	static void Work(shared_ptr<Workers> workers);
+	static void RunTasks(RunState &state);
+
+	shared_ptr<Workers> workers;
+};
+
+} // namespace duckdb
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
 #include "duckdb/common/string_util.hpp"
-#include <unordered_set>
+#include "re2/re2.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace duckdb {
 
@@ -22,10 +27,24 @@ namespace duckdb {
 //   pathvariable:no-cache:varname           - Disable caching of glob results
 //   pathvariable:append:varname!/path       - Append literal to paths
 //   pathvariable:append:varname!$other_var  - Append variable value to paths
+//   pathvariable:order!size:varname         - Largest files first
+//   pathvariable:order!none:varname         - Keep source order (no sort)
+//   pathvariable:race:mirrors               - Read from whichever mirror answers first
+//   pathvariable:race!2:mirrors             - Race only the first 2 mirrors
+//   pathvariable:cache:ref_data             - Read remote files from a local disk cache
+//   pathvariable:shard:targets              - Spread written files over target directories
+//   pathvariable:filter!\.parquet$:varname  - Keep paths matching a regex
+//   pathvariable:exclude!/tmp/:varname      - Drop paths matching a regex
+//   pathvariable:limit!100:varname          - Keep the first 100 paths
+//   pathvariable:where!region=eu:catalog    - Keep files whose record field or hive key matches
+//   pathvariable:since!$watermark:varname   - Keep files modified after a watermark
+//   pathvariable:prefetch!8:files           - Read the next 8 files into memory ahead of the scan
+//   pathvariable:capture!snap:src           - Keep the bytes read in variable snap
+//   pathvariable:capture!snap!full:src      - Same, reading the parts the reader skipped at close
 //
 
 // Modifier flags (can be combined)
-enum class PathVariableModifierFlag : uint8_t {
+enum class PathVariableModifierFlag : uint32_t {
 	NONE = 0,
 	NO_GLOB = 1 << 0,              // Disable glob expansion in paths
 	SEARCH = 1 << 1,               // Return only first existing match
@@ -34,16 +53,27 @@ enum class PathVariableModifierFlag : uint8_t {
 	PREPEND = 1 << 4,              // Prepend value to each path
 	PASSTHRU_SCALARFS = 1 << 5,    // Don't modify scalarfs protocol paths (data:, variable:, etc.)
 	PASSTHRU_EXPLICIT_FS = 1 << 6, // Don't modify paths with explicit protocols (://)
-	NO_CACHE = 1 << 7              // Disable caching of path resolution
+	NO_CACHE = 1 << 7,             // Disable caching of path resolution
+	ORDER = 1 << 8,                // Order of the glob result (order!name|size|none)
+	RACE = 1 << 9,                 // Open candidates concurrently, read from the first to respond
+	CACHE = 1 << 10,               // Serve remote files from the local disk cache
+	SHARD = 1 << 11,               // Spread written files over the listed target directories
+	FILTER = 1 << 12,              // Keep only paths matching a regex
+	EXCLUDE = 1 << 13,             // Drop paths matching a regex
+	LIMIT = 1 << 14,               // Keep only the first N paths
+	SINCE = 1 << 15,               // Keep only files modified after a watermark
+	PREFETCH = 1 << 16,            // Read the next files into memory in the background
+	CAPTURE = 1 << 17,             // Copy the bytes read into a variable
+	WHERE = 1 << 18                // Keep files whose record fields / hive keys match a predicate
 };
 
 // Enable bitwise operations on modifier flags
 inline PathVariableModifierFlag operator|(PathVariableModifierFlag a, PathVariableModifierFlag b) {
-	return static_cast<PathVariableModifierFlag>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+	return static_cast<PathVariableModifierFlag>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
 }
 
 inline PathVariableModifierFlag operator&(PathVariableModifierFlag a, PathVariableModifierFlag b) {
-	return static_cast<PathVariableModifierFlag>(static_cast<uint8_t>(a) & static_cast<uint8_t>(b));
+	return static_cast<PathVariableModifierFlag>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
 }
 
 inline PathVariableModifierFlag &operator|=(PathVariableModifierFlag &a, PathVariableModifierFlag b) {
@@ -52,7 +82,7 @@ inline PathVariableModifierFlag &operator|=(PathVariableModifierFlag &a, PathVar
 }
 
 inline bool HasFlag(PathVariableModifierFlag flags, PathVariableModifierFlag flag) {
-	return (static_cast<uint8_t>(flags) & static_cast<uint8_t>(flag)) != 0;
+	return (static_cast<uint32_t>(flags) & static_cast<uint32_t>(flag)) != 0;
 }
 
 // =============================================================================
@@ -76,6 +106,34 @@ struct PathVariableValue {
 	}
 };
 
+// Comparison of a where! predicate
+enum class PathVariableComparison : uint8_t { EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL };
+
+// A where!<field><op><value> predicate, evaluated on the fields of path
+// records and on the hive keys (key=value directories) of paths
+struct PathVariablePredicate {
+	string field;
+	PathVariableComparison comparison = PathVariableComparison::EQUAL;
+	PathVariableValue value;
+
+	// Compare a field value with the operand (both of the same type). NULL
+	// never matches, as in a WHERE clause.
+	bool Matches(const Value &field_value, const Value &operand) const;
+};
+
+// Order of the files returned by Glob
+enum class PathVariableOrder : uint8_t {
+	NAME = 0, // Lexicographic by path (default)
+	SIZE = 1, // Largest first, so big files do not straggle at the end of a scan
+	NONE = 2  // Source order: level 1 names, list order, listing order
+};
+
+// How shard assigns each new file to a target directory
+enum class PathVariableShardMode : uint8_t {
+	ROUND_ROBIN = 0, // Next target in turn (default)
+	LEAST_BYTES = 1  // Target with the fewest bytes written so far
+};
+
 struct ParsedPathVariablePath {
 	// The variable name (without modifiers)
 	string variable_name;
@@ -92,8 +150,40 @@ struct ParsedPathVariablePath {
 	// Whether this is a tmp_pathvariable: path
 	bool is_temp;
 
+	// Result order (if ORDER flag is set)
+	PathVariableOrder order;
+
+	// Number of candidates to race (if RACE flag is set), 0 for all
+	idx_t race_count;
+
+	// Target assignment (if SHARD flag is set)
+	PathVariableShardMode shard_mode;
+
+	// Regexes of filter! and exclude! modifiers (if FILTER / EXCLUDE flags are set)
+	vector<string> filter_patterns;
+	vector<string> exclude_patterns;
+
+	// Maximum number of paths (if LIMIT flag is set)
+	idx_t limit;
+
+	// Predicates of where! modifiers (if WHERE flag is set), all of which must hold
+	vector<PathVariablePredicate> where_predicates;
+
+	// Watermark of the since modifier (if SINCE flag is set): $variable or a literal
+	PathVariableValue since_value;
+
+	// Number of files to read ahead (if PREFETCH flag is set), 0 for the default
+	idx_t prefetch_window;
+
+	// Variable receiving the bytes read (if CAPTURE flag is set), and whether
+	// the rest of the file is read when it closes (capture!var!full)
+	string capture_variable;
+	bool capture_full;
+
 	ParsedPathVariablePath()
-	    : variable_name(), flags(PathVariableModifierFlag::NONE), append_value(), prepend_value(), is_temp(false) {
+	    : variable_name(), flags(PathVariableModifierFlag::NONE), append_value(), prepend_value(), is_temp(false),
+	      order(PathVariableOrder::NAME), race_count(0), shard_mode(PathVariableShardMode::ROUND_ROBIN), limit(0),
+	      prefetch_window(0), capture_full(false) {
 	}
 
 	bool HasModifier(PathVariableModifierFlag flag) const {
@@ -101,6 +191,90 @@ struct ParsedPathVariablePath {
 	}
 };
 
+// =============================================================================
+// PathVariablePipeline
+// =============================================================================
+//
+// The modifiers of a parsed path, compiled into the steps Glob runs in order:
+//   0. variables resolved into paths (where! drops path records whose fields
+//      do not match)
+//   1. prepend!value - cartesian product prefixes x paths
+//   2. append!value  - cartesian product paths x suffixes
+//      (paths matched by the passthrough predicates are left untouched)
+//   3. level 2 glob expansion (unless no-glob), with filter!/exclude!/where!
+//      and limit! applied as paths are generated - listing stops at the limit
+//   4. since!watermark - files modified after the watermark (limit! is then
+//      applied to the newer files rather than during generation)
+//   5. existence filter (search: first existing, no-missing: all existing)
+//   6. ordering (order!name, order!size, order!none)
+//   7. disk cache (Glob hands out remote files as pathvariable:cached: paths,
+//      read from local copies when opened)
+//   8. prefetch (Glob hands out the files as pathvariable:prefetched: paths,
+//      read ahead once the first of them is opened)
+//
+// With race, Glob stops short of these steps and returns the pathvariable:
+// path itself; OpenFile then runs them to get the mirror candidates and opens
+// them concurrently. capture does the same, and opens the one file they yield.
+//
+
+enum class PathVariableExistenceFilter : uint8_t {
+	NONE = 0,           // Keep every path
+	FIRST_EXISTING = 1, // search
+	ALL_EXISTING = 2    // no-missing
+};
+
+struct PathVariablePipeline {
+	bool has_prepend = false;
+	bool has_append = false;
+	bool expand_globs = true;
+	bool use_cache = true;
+	bool passthru_scalarfs = false;
+	bool passthru_explicit = false;
+	PathVariableExistenceFilter existence_filter = PathVariableExistenceFilter::NONE;
+	PathVariableOrder order = PathVariableOrder::NAME;
+	bool race = false;
+	idx_t race_count = 0;
+	bool disk_cache = false;
+	bool shard = false;
+	PathVariableShardMode shard_mode = PathVariableShardMode::ROUND_ROBIN;
+	// Compiled filter!/exclude! regexes, and the limit! count (0 for none)
+	vector<shared_ptr<const duckdb_re2::RE2>> filters;
+	vector<shared_ptr<const duckdb_re2::RE2>> excludes;
+	idx_t limit = 0;
+	vector<PathVariablePredicate> predicates;
+	bool since = false;
+	bool prefetch = false;
+	idx_t prefetch_window = 0;
+	bool capture = false;
+	string capture_variable;
+	bool capture_full = false;
+
+	static PathVariablePipeline Compile(const ParsedPathVariablePath &parsed);
+
+	// Whether append/prepend leave this path untouched
+	bool ShouldPassthru(const string &path) const;
+
+	// Whether a generated path passes the filter! and exclude! regexes
+	bool Accepts(const string &path) const;
+
+	// Apply the prepend and append cartesian products to resolved paths in a
+	// single pass, building the final list in one allocation
+	void Apply(vector<string> &paths, const vector<string> &prefixes, const vector<string> &suffixes) const;
+
+	// Join two path components with a single delimiter
+	static string JoinPaths(const string &base, const string &suffix);
+	// Paths handled by scalarfs itself (data:, variable:, pathvariable:)
+	static bool IsScalarfsPath(const string &path);
+	// Paths with an explicit protocol (s3://, https://, file://, ...)
+	static bool HasExplicitProtocol(const string &path);
+};
+
+// A parsed path together with its compiled pipeline
+struct CompiledPathVariablePath {
+	ParsedPathVariablePath parsed;
+	PathVariablePipeline pipeline;
+};
+
 // =============================================================================
 // PathVariableParser
 // =============================================================================
@@ -127,170 +301,41 @@ private:
 
 	// Parse a value (after !) which may be a literal or $variable reference
 	static PathVariableValue ParseValue(const string &value_str);
+
+	// Parse the positive count of race!k / limit!N / prefetch!k
+	static idx_t ParseCount(const string &mod_name, const string &mod_value, const string &expected);
+
+	// Parse the <field><op><value> of a where! modifier
+	static PathVariablePredicate ParsePredicate(const string &mod_value);
 };
 
 // =============================================================================
-// Implementation
+// PathVariableCompileCache
 // =============================================================================
+//
+// Parsed and compiled paths (modifier parsing, filter!/exclude! regexes), by
+// path string, owned by the PathVariableFileSystem. Compiling is a pure
+// function of the path, so entries never go stale; beyond MAX_ENTRIES the
+// least recently used path is evicted.
+//
 
-inline bool PathVariableParser::CanHandle(const string &path) {
-	return StringUtil::StartsWith(path, "pathvariable:") || StringUtil::StartsWith(path, "tmp_pathvariable:");
-}
-
-inline bool PathVariableParser::IsTempPath(const string &path) {
-	return StringUtil::StartsWith(path, "tmp_pathvariable:");
-}
-
-inline PathVariableValue PathVariableParser::ParseValue(const string &value_str) {
-	if (value_str.empty()) {
-		return PathVariableValue();
-	}
-	if (value_str[0] == '$') {
-		// Variable reference - strip the $
-		return PathVariableValue(value_str.substr(1), true);
-	}
-	// Literal value
-	return PathVariableValue(value_str, false);
-}
-
-inline bool PathVariableParser::ParseModifier(const string &modifier, ParsedPathVariablePath &result) {
-	// Check for modifiers with values (contain !)
-	auto bang_pos = modifier.find('!');
-	string mod_name = (bang_pos != string::npos) ? modifier.substr(0, bang_pos) : modifier;
-	string mod_value = (bang_pos != string::npos) ? modifier.substr(bang_pos + 1) : "";
-
-	if (mod_name == "no-glob") {
-		result.flags |= PathVariableModifierFlag::NO_GLOB;
-		return true;
-	}
-	if (mod_name == "search") {
-		result.flags |= PathVariableModifierFlag::SEARCH;
-		return true;
-	}
-	if (mod_name == "no-missing") {
-		result.flags |= PathVariableModifierFlag::IGNORE_MISSING;
-		return true;
-	}
-	if (mod_name == "no-scalarfs") {
-		result.flags |= PathVariableModifierFlag::PASSTHRU_SCALARFS;
-		return true;
-	}
-	if (mod_name == "no-protocols") {
-		result.flags |= PathVariableModifierFlag::PASSTHRU_EXPLICIT_FS;
-		return true;
-	}
-	if (mod_name == "no-cache") {
-		result.flags |= PathVariableModifierFlag::NO_CACHE;
-		return true;
-	}
-	if (mod_name == "append") {
-		result.flags |= PathVariableModifierFlag::APPEND;
-		result.append_value = ParseValue(mod_value);
-		return true;
-	}
-	if (mod_name == "prepend") {
-		result.flags |= PathVariableModifierFlag::PREPEND;
-		result.prepend_value = ParseValue(mod_value);
-		return true;
-	}
-
-	// Not a recognized modifier
-	return false;
-}
-
-inline ParsedPathVariablePath PathVariableParser::Parse(const string &path) {
-	ParsedPathVariablePath result;
-
-	// Determine prefix and starting position
-	string remainder;
-	if (StringUtil::StartsWith(path, "tmp_pathvariable:")) {
-		result.is_temp = true;
-		remainder = path.substr(17); // len("tmp_pathvariable:")
-	} else if (StringUtil::StartsWith(path, "pathvariable:")) {
-		result.is_temp = false;
-		remainder = path.substr(13); // len("pathvariable:")
-	} else {
-		// Not a pathvariable path - return empty result
-		return result;
-	}
-
-	// Split by colons to find modifiers
-	// Format: [modifier:]...[modifier:]varname[!value]
-	// The last segment (or first segment without a following colon) is the variable name
-	//
-	// We need to be careful: the variable name could contain a ! for append/prepend
-	// that was specified at the end rather than with the modifier
-	//
-	// Examples:
-	//   pathvariable:varname              -> varname
-	//   pathvariable:no-glob:varname      -> no-glob modifier, varname
-	//   pathvariable:search:varname       -> search modifier, varname
-	//   pathvariable:append:varname!/path -> append modifier with value, varname
-	//   pathvariable:append!/path:varname -> append modifier with value, varname (alt syntax)
-
-	vector<string> segments;
-	size_t start = 0;
-	size_t pos = 0;
-
-	while ((pos = remainder.find(':', start)) != string::npos) {
-		segments.push_back(remainder.substr(start, pos - start));
-		start = pos + 1;
-	}
-	// Add the last segment
-	segments.push_back(remainder.substr(start));
-
-	if (segments.empty()) {
-		return result;
-	}
+class PathVariableCompileCache {
+public:
+	static constexpr idx_t MAX_ENTRIES = 4096;
 
-	// Process segments from left to right
-	// Each segment is either a modifier or the variable name
-	// The variable name is the first segment that's NOT a recognized modifier
-	for (size_t i = 0; i < segments.size(); i++) {
-		const string &segment = segments[i];
-
-		// Try to parse as a modifier
-		if (ParseModifier(segment, result)) {
-			continue;
-		}
-
-		// Not a modifier - this is the variable name
-		// Everything from here to the end is part of the variable name (rejoin with :)
-		string var_part;
-		for (size_t j = i; j < segments.size(); j++) {
-			if (j > i) {
-				var_part += ":";
-			}
-			var_part += segments[j];
-		}
-
-		// Check for ! in the variable part (for append/prepend values specified at end)
-		// But only if we don't already have an append value
-		auto bang_pos = var_part.find('!');
-		if (bang_pos != string::npos && result.append_value.IsEmpty() && result.prepend_value.IsEmpty()) {
-			// This could be varname!value syntax
-			// Only treat as value if we have an append or prepend modifier without a value
-			if (HasFlag(result.flags, PathVariableModifierFlag::APPEND) ||
-			    HasFlag(result.flags, PathVariableModifierFlag::PREPEND)) {
-				result.variable_name = var_part.substr(0, bang_pos);
-				auto value = ParseValue(var_part.substr(bang_pos + 1));
-				if (HasFlag(result.flags, PathVariableModifierFlag::APPEND)) {
-					result.append_value = value;
-				} else {
-					result.prepend_value = value;
-				}
-			} else {
-				// No append/prepend modifier, so ! is part of the variable name
-				// (unlikely but possible)
-				result.variable_name = var_part;
-			}
-		} else {
-			result.variable_name = var_part;
-		}
-		break;
-	}
+	// Parse and compile a path, or return the cached result
+	shared_ptr<const CompiledPathVariablePath> Compile(const string &path);
 
-	return result;
-}
+private:
+	struct Entry {
+		shared_ptr<const CompiledPathVariablePath> compiled;
+		std::list<string>::iterator position;
+	};
+
+	std::mutex lock;
+	// Paths, most recently used first
+	std::list<string> recency;
+	std::unordered_map<string, Entry> entries;
+};
 
 } // namespace duckdb
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "pathvariable_io_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// =============================================================================
+// PathVariablePrefetch
+// =============================================================================
+//
+// Background prefetch of a glob result (prefetch modifier):
+//
+//   SELECT * FROM read_csv('pathvariable:prefetch!8:files');
+//
+// Glob registers the resolved files as a pipeline and hands out each file as
+// pathvariable:prefetched:<path> - the path itself is unchanged behind the
+// prefix, which only routes the open back to the pathvariable filesystem.
+// Nothing is read until a file is opened: each open moves the window forward
+// and queues fetches of the next k files (in glob order) on the IO pool.
+// Opening a prefetched path serves the buffered bytes, waiting for a fetch
+// that is queued or in flight. Files that were not fetched are opened
+// directly, so the scan never depends on the prefetch succeeding.
+//
+// Memory: all pipelines share pathvariable_prefetch_max_memory bytes. A file
+// that does not fit in what is left is read directly. A buffer is handed over
+// to the first open of its file and leaves the budget (a later open, e.g. the
+// scan after the CSV sniffer, reads the file directly). Buffers of files the
+// scan skipped are released once it is k files past them, and all of a
+// pipeline's buffers when the query that globbed it ends.
+//
+
+class PathVariablePrefetch : public enable_shared_from_this<PathVariablePrefetch> {
+public:
+	PathVariablePrefetch(weak_ptr<ClientContext> context, weak_ptr<PathVariableIOPool> io_pool, vector<string> paths,
+	                     idx_t window, idx_t max_in_flight, shared_ptr<std::atomic<idx_t>> used_bytes,
+	                     idx_t max_bytes);
+
+	// The content of a file if it was prefetched (waits for a queued fetch or
+	// one in flight), moved out of the pipeline; false to open it directly.
+	// Moves the window past the file.
+	bool Take(idx_t index, string &data);
+
+	// Cancel queued fetches and release every buffer; fetches in flight drop
+	// their bytes when they complete
+	void Stop();
+
+	// Whether the glob result this pipeline was registered for matches
+	bool Matches(const vector<string> &other_paths) const;
+
+private:
+	enum class FileState : uint8_t { PENDING, FETCHING, READY, DIRECT };
+
+	// Mark the files of the window for fetching (lock held); the caller
+	// submits them once the lock is released
+	vector<idx_t> Schedule();
+	void Submit(const vector<idx_t> &indexes);
+	void FetchJob(idx_t index);
+	// Read a whole file, reserving its size from the budget; false to leave it
+	bool Fetch(const string &path, string &data);
+	void Release(idx_t index);
+
+	// Files are read through the context's filesystem (secrets, settings); the
+	// fetches stop once the context is gone
+	weak_ptr<ClientContext> context;
+	// Jobs run on the pool of the filesystem, which must not be kept alive by them
+	weak_ptr<PathVariableIOPool> io_pool;
+	vector<string> paths;
+	idx_t window;
+	idx_t max_in_flight;
+	shared_ptr<std::atomic<idx_t>> used_bytes;
+	idx_t max_bytes;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	vector<FileState> states;
+	vector<string> buffers;
+	// Next file to fetch, and one past the furthest file opened
+	idx_t next_fetch = 0;
+	idx_t frontier = 0;
+	// Fetches submitted and not completed
+	idx_t in_flight = 0;
+	// Buffers before this index are released (or were handed over)
+	idx_t released = 0;
+	bool stopping = false;
+};
+
+// =============================================================================
+// PathVariablePrefetcher
+// =============================================================================
+//
+// The prefetch pipelines of a ClientContext, by the files they serve. The
+// pipelines of a query are stopped when it ends (QueryEnd), whether or not its
+// files were opened - a plain glob(), a LIMIT or an error leaves nothing behind.
+// Files opened through it are counted, see pathvariable_prefetch_stats().
+//
+
+class PathVariablePrefetcher : public ClientContextState {
+public:
+	static constexpr idx_t MAX_PIPELINES = 16;
+	static constexpr idx_t DEFAULT_WINDOW = 4;
+	static constexpr const char *MAX_MEMORY_SETTING = "pathvariable_prefetch_max_memory";
+	static constexpr uint64_t DEFAULT_MAX_MEMORY = 256ULL * 1024 * 1024;
+
+	~PathVariablePrefetcher() override;
+
+	// Get (or create) the prefetcher registered for this context
+	static PathVariablePrefetcher &Get(ClientContext &context);
+
+	// Register a pipeline over paths (or keep the one registered over the same
+	// paths, when a query globs twice). Nothing is fetched until a file is opened.
+	void AddPipeline(ClientContext &context, const shared_ptr<PathVariableIOPool> &io_pool, vector<string> paths,
+	                 idx_t window, idx_t max_in_flight, shared_ptr<std::atomic<idx_t>> used_bytes, idx_t max_bytes);
+
+	// The content of a file, if its pipeline prefetched it
+	bool Take(const string &path, string &data);
+
+	// Stop and drop the pipelines of the query
+	void QueryEnd(ClientContext &context) override;
+
+	// pathvariable:prefetched:<path>
+	static string GetPrefetchedPath(const string &path);
+	static bool IsPrefetchedPath(const string &path);
+	// The path behind a prefetched path; false if it is not one
+	static bool ParsePrefetchedPath(const string &path, string &target);
+
+	static uint64_t GetMaxMemory(ClientContext &context);
+
+	// Register pathvariable_prefetch_stats()
+	static void Register(ExtensionLoader &loader);
+
+	// Files opened through prefetched paths on this context
+	std::atomic<idx_t> files_from_memory {0};
+	std::atomic<idx_t> bytes_from_memory {0};
+	std::atomic<idx_t> files_read_directly {0};
+
+private:
+	struct PipelineEntry {
+		shared_ptr<PathVariablePrefetch> pipeline;
+		idx_t index;
+	};
+
+	void StopAll();
+
+	std::mutex lock;
+	vector<shared_ptr<PathVariablePrefetch>> pipelines;
+	std::unordered_map<string, PipelineEntry> files;
+};
+
+} // namespace duckdb
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "pathvariable_io_pool.hpp"
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// =============================================================================
+// PathVariableWatermarks
+// =============================================================================
+//
+// Watermarks for incremental loads with the since modifier, kept per
+// ClientContext:
+//
+//   SELECT * FROM read_csv('pathvariable:since!$last_watermark:inputs');
+//   SET VARIABLE last_watermark = pathvariable_max_mtime('pathvariable:since!$last_watermark:inputs');
+//
+// Every since! expansion records, for its path string, the newest last
+// modified time among the files it returned (or the watermark itself when no
+// file is newer). pathvariable_max_mtime() returns that record, so the next
+// watermark covers exactly the files that were read - files that arrived
+// after the read are picked up by the next run. Paths without a record are
+// expanded on the spot.
+//
+// Modification times the expansions had to look up (files whose listing does
+// not report one) are kept by file path as well, so pathvariable_max_mtime()
+// on a path without a record opens only files no expansion has seen.
+//
+
+class PathVariableWatermarks : public ClientContextState {
+public:
+	static constexpr idx_t MAX_ENTRIES = 1024;
+	static constexpr idx_t MAX_FILE_ENTRIES = 65536;
+
+	// Get (or create) the watermarks registered for this context
+	static PathVariableWatermarks &Get(ClientContext &context);
+
+	void Record(const string &path, timestamp_t max_last_modified);
+	bool Lookup(const string &path, timestamp_t &max_last_modified);
+
+	// Modification times looked up while expanding, by file path
+	void RecordLastModified(const string &file_path, timestamp_t last_modified);
+	bool LookupLastModified(const string &file_path, timestamp_t &last_modified);
+
+	// The last modified time a listing attached to the result (extended_info
+	// "last_modified"), if any
+	static bool GetListedLastModified(const OpenFileInfo &info, timestamp_t &last_modified);
+	// Attach a last modified time to a result, as a listing would
+	static void SetListedLastModified(OpenFileInfo &info, timestamp_t last_modified);
+
+	// A watermark value as a timestamp (TIMESTAMP, TIMESTAMPTZ, DATE or a
+	// string); false if it is NULL
+	static bool GetTimestampFromValue(const Value &value, timestamp_t &result);
+
+	// Register pathvariable_max_mtime(), which looks up modification times on io_pool
+	static void Register(ExtensionLoader &loader, shared_ptr<PathVariableIOPool> io_pool);
+
+private:
+	std::mutex lock;
+	std::unordered_map<string, timestamp_t> watermarks;
+	std::unordered_map<string, timestamp_t> file_last_modified;
+};
+
+} // namespace duckdb
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "scalarfs_native_format.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// read_variable Table Function
+// =============================================================================
+//
+// Scans a variable (typically produced by COPY ... (FORMAT variable)) directly
+// into DataChunks, without going through unnest() in the expression engine.
+//
+// Usage:
+//   SELECT * FROM read_variable('x');
+//   SELECT id FROM read_variable('x') WHERE score > 0.5;
+//
+// Layouts (detected from the variable's type):
+//   - LIST(STRUCT)           → one row per element, one column per field
+//   - STRUCT of LISTs        → one row per list index, one column per field
+//                              (as written by LIST columns; columnar := false
+//                              reads it as a single row instead)
+//   - LIST(T)                → one row per element, single column "value"
+//   - STRUCT                 → single row, one column per field
+//   - scalar                 → single row, single column "value"
+//   - scalarfs_native BLOB   → the stored table, deserialized chunk by chunk
+//
+// Rows are handed out to threads in ranges of STANDARD_VECTOR_SIZE. Only
+// projected columns are materialized, and pushed-down filters are evaluated
+// per row before any projected column is produced.
+//
+
+enum class ReadVariableLayout : uint8_t {
+	SCALAR = 0,  // Single value
+	STRUCT = 1,  // Single row of struct fields
+	VALUES = 2,  // List of values
+	ROWS = 3,    // List of structs
+	COLUMNS = 4, // Struct of equal-length lists
+	NATIVE = 5   // BLOB written by FORMAT scalarfs_native
+};
+
+struct ReadVariableBindData : public TableFunctionData {
+	string variable_name;
+	Value value;
+	ReadVariableLayout layout;
+	idx_t row_count;
+	vector<LogicalType> types;
+	// NATIVE layout: raw blob bytes and its parsed footer
+	string native_data;
+	ScalarfsNativeFooter native_footer;
+	// NATIVE layout: row number of each chunk's first row
+	vector<idx_t> native_row_starts;
+
+	ReadVariableBindData(string var_name, Value value_p, ReadVariableLayout layout_p, idx_t rows,
+	                     vector<LogicalType> types_p)
+	    : variable_name(std::move(var_name)), value(std::move(value_p)), layout(layout_p), row_count(rows),
+	      types(std::move(types_p)) {
+	}
+};
+
+class ReadVariableFunction {
+public:
+	static void Register(ExtensionLoader &loader);
+	static TableFunction GetFunction();
+
+private:
+	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+	                                     vector<LogicalType> &return_types, vector<string> &names);
+	static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input);
+	static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+	                                                     GlobalTableFunctionState *global_state);
+	static void Scan(ClientContext &context, TableFunctionInput &data, DataChunk &output);
+	static void ScanNative(ClientContext &context, TableFunctionInput &data, DataChunk &output);
+	static unique_ptr<NodeStatistics> Cardinality(ClientContext &context, const FunctionData *bind_data);
+};
+
+} // namespace duckdb
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// scalarfs native format
+// =============================================================================
+//
+// A binary encoding of a query result, stored as a BLOB variable by
+// COPY ... (FORMAT scalarfs_native) and read back by read_variable().
+// Chunks use DuckDB's own DataChunk serialization (columnar vectors), so
+// reading is close to a memcpy and involves no Value construction or parsing.
+//
+// Layout:
+//   [magic: 8 bytes]
+//   [chunk 0] [chunk 1] ...        - one serialized DataChunk each
+//   [footer]                       - names, types, chunk offsets and row counts
+//   [footer offset: uint64]
+//   [magic: 8 bytes]
+//
+// The footer records where each chunk starts, so chunks can be deserialized
+// independently (and in parallel) without scanning the blob.
+//
+
+struct ScalarfsNativeFooter {
+	vector<string> names;
+	vector<LogicalType> types;
+	// Byte offset of each serialized chunk within the blob
+	vector<idx_t> chunk_offsets;
+	// Number of rows in each chunk
+	vector<idx_t> chunk_rows;
+	idx_t row_count = 0;
+};
+
+class ScalarfsNativeFormat {
+public:
+	static constexpr const char *MAGIC = "SFSNATV1";
+	static constexpr idx_t MAGIC_SIZE = 8;
+
+	// Serialize a collected result into the native format
+	static string Serialize(ColumnDataCollection &results, const vector<string> &names);
+
+	// Check whether a blob looks like native format data
+	static bool IsNative(const string &data);
+
+	// Read the footer (throws InvalidInputException on malformed data)
+	static ScalarfsNativeFooter ReadFooter(const string &data);
+
+	// Deserialize chunk chunk_idx of the footer into an empty DataChunk,
+	// checking it against the footer's schema and row count
+	static void ReadChunk(const string &data, const ScalarfsNativeFooter &footer, idx_t chunk_idx, DataChunk &chunk);
+};
+
+} // namespace duckdb
@@ -2,6 +2,7 @@
 
 #include "duckdb.hpp"
 #include "duckdb/function/copy_function.hpp"
+#include "duckdb/common/random_engine.hpp"
 #include "duckdb/common/types/column/column_data_collection.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 
@@ -28,13 +29,40 @@ namespace duckdb {
 //   - none: Single value only, error if >1 row
 //   - scalar: Single column only, error if >1 column
 //       1 row → scalar, N rows → list
+//   - columns: Columnar layout, one struct of typed lists
+//       {col1: [v1, v2, ...], col2: [v1, v2, ...]}
+//       Built column-at-a-time, avoiding a STRUCT value per row
+//   - map: MAP keyed by one column (KEY option, default: first column)
+//       2 cols → MAP(key, value), N cols → MAP(key, struct of the other columns)
+//       Errors on NULL or duplicate keys
+//
+// Limits (enforced while rows are sunk, aborting the COPY early):
+//   - MAX_ROWS n:  error once more than n rows have been produced
+//   - MAX_BYTES s: error once buffered results exceed s (e.g. 100000, '64MB')
+//   LIST none implies MAX_ROWS 1.
+//
+// Bounded results (memory stays O(n) regardless of input size):
+//   - LIMIT n:  keep the first n rows that reach the sink, drop the rest
+//   - SAMPLE n: keep a uniform random sample of n rows (reservoir sampling in
+//               thread-local sinks, merged in Combine)
+//
+// APPEND true: extend the existing LIST variable instead of replacing it.
+//   New rows are appended as elements (values for 1 column, structs for N
+//   columns; with LIST columns each field list is extended). The element type
+//   must match the existing list. A missing or NULL variable starts a new list.
+//
+// FORMAT scalarfs_native shares the same sink, but stores the result as a BLOB
+// in the native binary format (see scalarfs_native_format.hpp) instead of
+// building Values. Read it back with read_variable().
 //
 
 enum class VariableCopyListMode : uint8_t {
-	AUTO = 0,  // Smart detection
-	ROWS = 1,  // Always list of structs
-	NONE = 2,  // Single value only (error if >1 row)
-	SCALAR = 3 // Single column only (error if >1 column)
+	AUTO = 0,    // Smart detection
+	ROWS = 1,    // Always list of structs
+	NONE = 2,    // Single value only (error if >1 row)
+	SCALAR = 3,  // Single column only (error if >1 column)
+	COLUMNS = 4, // Struct of lists, one list per column
+	MAP = 5      // MAP keyed by one column
 };
 
 struct VariableCopyBindData : public FunctionData {
@@ -42,6 +70,18 @@ struct VariableCopyBindData : public FunctionData {
 	VariableCopyListMode list_mode;
 	vector<string> column_names;
 	vector<LogicalType> column_types;
+	// Row and byte limits checked in Sink (DConstants::INVALID_INDEX = unlimited)
+	idx_t max_rows = DConstants::INVALID_INDEX;
+	idx_t max_bytes = DConstants::INVALID_INDEX;
+	// FORMAT scalarfs_native: store a native-format BLOB instead of a Value tree
+	bool native = false;
+	// APPEND true: extend the existing list rather than replacing it
+	bool append = false;
+	// LIST map: index of the key column
+	idx_t key_column = 0;
+	// LIMIT n / SAMPLE n (DConstants::INVALID_INDEX = keep all rows)
+	idx_t limit = DConstants::INVALID_INDEX;
+	idx_t sample_size = DConstants::INVALID_INDEX;
 
 	VariableCopyBindData(string var_name, VariableCopyListMode mode, vector<string> names, vector<LogicalType> types)
 	    : variable_name(std::move(var_name)), list_mode(mode), column_names(std::move(names)),
@@ -49,22 +89,42 @@ struct VariableCopyBindData : public FunctionData {
 	}
 
 	unique_ptr<FunctionData> Copy() const override {
-		return make_uniq<VariableCopyBindData>(variable_name, list_mode, column_names, column_types);
+		auto result = make_uniq<VariableCopyBindData>(variable_name, list_mode, column_names, column_types);
+		result->max_rows = max_rows;
+		result->max_bytes = max_bytes;
+		result->native = native;
+		result->append = append;
+		result->key_column = key_column;
+		result->limit = limit;
+		result->sample_size = sample_size;
+		return std::move(result);
 	}
 
 	bool Equals(const FunctionData &other) const override {
 		auto &o = other.Cast<VariableCopyBindData>();
-		return variable_name == o.variable_name && list_mode == o.list_mode;
+		return variable_name == o.variable_name && list_mode == o.list_mode && max_rows == o.max_rows &&
+		       max_bytes == o.max_bytes && native == o.native && append == o.append &&
+		       key_column == o.key_column && limit == o.limit && sample_size == o.sample_size;
 	}
 };
 
+// A sampled row with its random key - reservoirs keep the rows with the largest keys
+struct VariableCopySampleRow {
+	double key;
+	vector<Value> values;
+};
+
 struct VariableCopyGlobalState : public GlobalFunctionData {
 	unique_ptr<ColumnDataCollection> results;
+	// SAMPLE n: merged reservoir, moved into results on Finalize
+	vector<VariableCopySampleRow> reservoir;
 	mutex lock;
 };
 
 struct VariableCopyLocalState : public LocalFunctionData {
-	// Thread-local state (currently unused, but required by interface)
+	// SAMPLE n: thread-local reservoir (min-heap on key) and its random source
+	vector<VariableCopySampleRow> reservoir;
+	RandomEngine random;
 };
 
 class VariableCopyFunction {
@@ -74,6 +134,9 @@ public:
 	static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInput &input,
 	                                     const vector<string> &names, const vector<LogicalType> &sql_types);
 
+	static unique_ptr<FunctionData> NativeBind(ClientContext &context, CopyFunctionBindInput &input,
+	                                           const vector<string> &names, const vector<LogicalType> &sql_types);
+
 	static unique_ptr<GlobalFunctionData> InitializeGlobal(ClientContext &context, FunctionData &bind_data,
 	                                                       const string &file_path);
 
@@ -89,7 +152,15 @@ public:
 
 private:
 	static string ExtractVariableName(const string &path);
+	static idx_t ParseLimitOption(const string &name, const vector<Value> &values, bool is_bytes);
+	static void CheckLimits(const VariableCopyBindData &bind_data, idx_t row_count, idx_t byte_count);
+	static void AddToReservoir(vector<VariableCopySampleRow> &reservoir, idx_t sample_size, VariableCopySampleRow row);
+	static void SinkSample(const VariableCopyBindData &bind_data, VariableCopyLocalState &state, DataChunk &input);
 	static Value ConvertToValue(ColumnDataCollection &results, const VariableCopyBindData &bind_data);
+	static Value ConvertToColumns(ColumnDataCollection &results, const VariableCopyBindData &bind_data);
+	static Value ConvertToMap(ColumnDataCollection &results, const VariableCopyBindData &bind_data);
+	static Value ConvertToAppendValue(ColumnDataCollection &results, const VariableCopyBindData &bind_data);
+	static Value AppendToExisting(const Value &existing, const Value &appended, const VariableCopyBindData &bind_data);
 };
 
 } // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <bitset>
+
+namespace duckdb {
+
+// =============================================================================
+// VariableGlobPattern
+// =============================================================================
+//
+// A glob pattern on variable names, compiled once and matched against every
+// candidate name of a glob call.
+//
+// Pattern syntax:
+//   *        - matches any sequence of characters (including none)
+//   ?        - matches any single character
+//   [abc]    - matches any character in the set
+//   [a-z0-9] - ranges may be mixed with single characters
+//   [!abc]   - matches any character NOT in the set ([^abc] also works)
+//   \x       - matches x literally (e.g. \* or \[)
+//
+// A ']' directly after '[' (or '[!') is part of the set. A '[' without a
+// closing ']' matches a literal '['.
+//
+// Compilation turns the pattern into a short token program (literal runs,
+// single-char wildcards, 256-bit class tables and stars). The literal prefix
+// and suffix are checked with memcmp before running the program, which
+// rejects most non-matching names without touching the tokens at all.
+//
+
+class VariableGlobPattern {
+public:
+	explicit VariableGlobPattern(const string &pattern);
+
+	bool Matches(const string &name) const;
+
+	// Literal characters every match starts with (up to the first wildcard)
+	const string &GetPrefix() const {
+		return prefix;
+	}
+
+private:
+	enum class TokenType : uint8_t {
+		LITERAL = 0, // Run of literal characters
+		ANY = 1,     // ?
+		CLASS = 2,   // [...]
+		STAR = 3     // *
+	};
+
+	struct Token {
+		TokenType type;
+		string literal;
+		std::bitset<256> chars;
+	};
+
+	// Match the token program against name[start, end)
+	bool MatchTokens(const char *name, idx_t start, idx_t end) const;
+	// Try to match a single non-star token at name[pos]; advances pos
+	bool MatchToken(const Token &token, const char *name, idx_t &pos, idx_t end) const;
+
+	vector<Token> tokens;
+	// Literal prefix/suffix, and the token range left between them
+	string prefix;
+	string suffix;
+	idx_t token_begin = 0;
+	idx_t token_end = 0;
+	// Minimum name length any match must have
+	idx_t min_length = 0;
+	bool has_star = false;
+};
+
+} // namespace duckdb
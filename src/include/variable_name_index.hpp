@@ -0,0 +1,58 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include <mutex>
+#include <set>
+
+namespace duckdb {
+
+// =============================================================================
+// VariableNameIndex
+// =============================================================================
+//
+// A sorted index of user variable names, kept per ClientContext, used to
+// resolve glob patterns on variable names (variable:data_* and level 1 of
+// pathvariable: globs) without scanning every variable.
+//
+// A pattern's literal prefix (everything before the first glob character)
+// selects a contiguous range of the sorted names, so data_2026_* resolves in
+// O(log n + k) and matches come out already sorted.
+//
+// Keeping it up to date:
+//   - scalarfs' own writes (variable: handles, FORMAT variable, MoveFile,
+//     RemoveFile) call NotifySet/NotifyReset to update the index in place
+//   - SET/RESET statements mark the index dirty when they are prepared
+//     (OnFinalizePrepare) and whenever they run (OnExecutePrepared, which also
+//     covers EXECUTE of a prepared SET), and it is rebuilt on the next lookup
+//   - a variable count mismatch also triggers a rebuild, and every candidate is
+//     re-checked against the variable map, so stale entries are never returned
+//
+
+class VariableNameIndex : public ClientContextState {
+public:
+	// Get (or create) the index registered for this context
+	static VariableNameIndex &Get(ClientContext &context);
+
+	// Record that scalarfs set or reset a variable
+	static void NotifySet(ClientContext &context, const string &name);
+	static void NotifyReset(ClientContext &context, const string &name);
+
+	// Return the names of existing variables matching a glob pattern, sorted
+	vector<string> Match(ClientContext &context, const string &pattern);
+
+	RebindQueryInfo OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+	                                  PreparedStatementMode mode) override;
+	RebindQueryInfo OnExecutePrepared(ClientContext &context, PreparedStatementCallbackInfo &info,
+	                                  RebindQueryInfo current_rebind) override;
+
+private:
+	void Rebuild(ClientContext &context);
+
+	std::mutex lock;
+	std::set<string> names;
+	bool dirty = true;
+};
+
+} // namespace duckdb
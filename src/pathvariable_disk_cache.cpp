@@ -0,0 +1,378 @@
+#include "pathvariable_disk_cache.hpp"
+#include "pathvariable_modifiers.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/types/uuid.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+static constexpr const char *CACHED_PREFIX = "pathvariable:cached:";
+
+bool PathVariableDiskCache::IsRemotePath(const string &path) {
+	return PathVariablePipeline::HasExplicitProtocol(path) && !StringUtil::StartsWith(path, "file://");
+}
+
+string PathVariableDiskCache::GetCachedPath(const string &path) {
+	return CACHED_PREFIX + path;
+}
+
+bool PathVariableDiskCache::IsCachedPath(const string &path) {
+	return StringUtil::StartsWith(path, CACHED_PREFIX);
+}
+
+bool PathVariableDiskCache::ParseCachedPath(const string &path, string &target) {
+	if (!IsCachedPath(path)) {
+		return false;
+	}
+	target = path.substr(strlen(CACHED_PREFIX));
+	return !target.empty();
+}
+
+string PathVariableDiskCache::GetDirectory(ClientContext &context, FileSystem &fs) {
+	Value setting;
+	if (context.TryGetCurrentSetting(DIRECTORY_SETTING, setting) && !setting.IsNull()) {
+		auto cache_directory = setting.ToString();
+		if (!cache_directory.empty()) {
+			return cache_directory;
+		}
+	}
+	auto home = FileSystem::GetHomeDirectory(nullptr);
+	if (home.empty()) {
+		throw IOException("pathvariable: cache needs a home directory or %s to be set", DIRECTORY_SETTING);
+	}
+	return fs.JoinPath(fs.JoinPath(home, ".duckdb"), "scalarfs_cache");
+}
+
+uint64_t PathVariableDiskCache::GetMaxSize(ClientContext &context) {
+	Value max_size;
+	if (context.TryGetCurrentSetting(MAX_SIZE_SETTING, max_size) && !max_size.IsNull()) {
+		return max_size.GetValue<uint64_t>();
+	}
+	return DEFAULT_MAX_SIZE;
+}
+
+string PathVariableDiskCache::GetCacheFileName(const string &path, idx_t size, timestamp_t last_modified,
+                                               const string &etag) {
+	hash_t key = Hash(path.c_str(), path.size());
+	key = CombineHash(key, Hash<idx_t>(size));
+	key = CombineHash(key, Hash<int64_t>(last_modified.value));
+	key = CombineHash(key, Hash(etag.c_str(), etag.size()));
+
+	static const char *const HEX_DIGITS = "0123456789abcdef";
+	string name;
+	for (int shift = 60; shift >= 0; shift -= 4) {
+		name += HEX_DIGITS[(key >> shift) & 0xF];
+	}
+
+	// Keep the remote file name (without query string) to make the directory browsable
+	auto base = path.substr(path.find_last_of('/') + 1);
+	base = base.substr(0, base.find('?'));
+	if (base.size() > 64) {
+		base = base.substr(base.size() - 64);
+	}
+	name += "-";
+	for (auto c : base) {
+		bool safe =
+		    StringUtil::CharacterIsAlpha(c) || StringUtil::CharacterIsDigit(c) || c == '.' || c == '_' || c == '-';
+		name += safe ? c : '_';
+	}
+	return name;
+}
+
+void PathVariableDiskCache::LoadDirectory(FileSystem &fs, const string &cache_directory) {
+	if (loaded && directory == cache_directory) {
+		return;
+	}
+	entries.clear();
+	total_size = 0;
+	directory = cache_directory;
+	loaded = true;
+
+	// Create the directory and any missing parents
+	vector<string> missing;
+	string current = cache_directory;
+	while (!current.empty() && !fs.DirectoryExists(current)) {
+		missing.push_back(current);
+		auto sep_pos = current.find_last_of("/\\");
+		if (sep_pos == string::npos || sep_pos == 0) {
+			break;
+		}
+		current = current.substr(0, sep_pos);
+	}
+	for (auto it = missing.rbegin(); it != missing.rend(); ++it) {
+		fs.CreateDirectory(*it);
+	}
+
+	// Index files left by earlier sessions; in-progress downloads (.tmp) are skipped
+	vector<string> names;
+	fs.ListFiles(cache_directory, [&](const string &name, bool is_directory) {
+		if (!is_directory && !StringUtil::EndsWith(name, ".tmp")) {
+			names.push_back(name);
+		}
+	});
+	for (auto &name : names) {
+		auto cache_file = fs.JoinPath(cache_directory, name);
+		auto handle = fs.OpenFile(cache_file, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			continue;
+		}
+		Entry entry {string(), handle->GetFileSize(), fs.GetLastModifiedTime(*handle)};
+		total_size += entry.size;
+		entries.emplace(std::move(cache_file), std::move(entry));
+	}
+}
+
+bool PathVariableDiskCache::Reserve(FileSystem &fs, idx_t needed, idx_t max_size) {
+	if (needed > max_size) {
+		return false;
+	}
+	if (total_size + needed <= max_size) {
+		return true;
+	}
+
+	// Least recently used first; recently used files may be part of a running scan
+	auto now = Timestamp::GetCurrentTimestamp();
+	timestamp_t cutoff(now.value - EVICTION_GRACE_SECONDS * Interval::MICROS_PER_SEC);
+	vector<std::pair<timestamp_t, string>> candidates;
+	for (auto &entry : entries) {
+		if (entry.second.last_access < cutoff) {
+			candidates.emplace_back(entry.second.last_access, entry.first);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	for (auto &candidate : candidates) {
+		if (total_size + needed <= max_size) {
+			break;
+		}
+		if (!fs.TryRemoveFile(candidate.second)) {
+			continue;
+		}
+		total_size -= entries[candidate.second].size;
+		entries.erase(candidate.second);
+	}
+	return total_size + needed <= max_size;
+}
+
+string PathVariableDiskCache::Materialize(ClientContext &context, FileSystem &fs, const string &path) {
+	if (!IsRemotePath(path)) {
+		return path;
+	}
+	auto max_size = GetMaxSize(context);
+	if (max_size == 0) {
+		return path;
+	}
+	auto cache_directory = GetDirectory(context, fs);
+
+	// The remote version: size plus last modified time and/or ETag
+	auto remote = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	idx_t size = remote->GetFileSize();
+	timestamp_t last_modified(0);
+	bool has_last_modified = false;
+	try {
+		last_modified = remote->file_system.GetLastModifiedTime(*remote);
+		has_last_modified = true;
+	} catch (...) {
+	}
+	string etag;
+	try {
+		etag = remote->file_system.GetVersionTag(*remote);
+	} catch (...) {
+	}
+	if (!has_last_modified && etag.empty()) {
+		// Without a version, a cached copy could never be validated
+		return path;
+	}
+
+	auto cache_file = fs.JoinPath(cache_directory, GetCacheFileName(path, size, last_modified, etag));
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		LoadDirectory(fs, cache_directory);
+		auto entry = entries.find(cache_file);
+		if (entry != entries.end()) {
+			if (fs.FileExists(cache_file)) {
+				entry->second.last_access = Timestamp::GetCurrentTimestamp();
+				entry->second.source_path = path;
+				return cache_file;
+			}
+			// Deleted behind our back
+			total_size -= entry->second.size;
+			entries.erase(entry);
+		}
+		if (downloading.find(cache_file) != downloading.end() || !Reserve(fs, size, max_size)) {
+			return path;
+		}
+		downloading.insert(cache_file);
+		total_size += size;
+	}
+
+	// Download into a unique temp file, then move it into place, so readers
+	// (and other processes sharing the directory) never see a partial file
+	auto tmp_file = cache_file + "." + UUID::ToString(UUID::GenerateRandomUUID()) + ".tmp";
+	bool downloaded = false;
+	try {
+		auto local = fs.OpenFile(tmp_file, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		auto buffer = make_unsafe_uniq_array<data_t>(COPY_BUFFER_SIZE);
+		for (idx_t offset = 0; offset < size;) {
+			idx_t chunk = size - offset;
+			if (chunk > COPY_BUFFER_SIZE) {
+				chunk = COPY_BUFFER_SIZE;
+			}
+			remote->Read(buffer.get(), chunk, offset);
+			local->Write(buffer.get(), chunk, offset);
+			offset += chunk;
+		}
+		local->Sync();
+		local->Close();
+		fs.MoveFile(tmp_file, cache_file);
+		downloaded = true;
+	} catch (...) {
+		// The cache is an optimization - fall back to reading remotely
+		fs.TryRemoveFile(tmp_file);
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	downloading.erase(cache_file);
+	if (directory != cache_directory) {
+		// The directory setting changed meanwhile; the file is indexed when it is used again
+		return downloaded ? cache_file : path;
+	}
+	if (!downloaded) {
+		total_size -= size;
+		return path;
+	}
+	entries[cache_file] = Entry {path, size, Timestamp::GetCurrentTimestamp()};
+	return cache_file;
+}
+
+vector<PathVariableDiskCache::EntryInfo> PathVariableDiskCache::GetEntries(ClientContext &context, FileSystem &fs) {
+	auto cache_directory = GetDirectory(context, fs);
+	std::lock_guard<std::mutex> guard(lock);
+	LoadDirectory(fs, cache_directory);
+
+	vector<EntryInfo> result;
+	for (auto &entry : entries) {
+		result.push_back(
+		    EntryInfo {entry.first, entry.second.source_path, entry.second.size, entry.second.last_access});
+	}
+	std::sort(result.begin(), result.end(), [](const EntryInfo &a, const EntryInfo &b) {
+		return a.last_access > b.last_access || (a.last_access == b.last_access && a.cache_file < b.cache_file);
+	});
+	return result;
+}
+
+idx_t PathVariableDiskCache::Clear(ClientContext &context, FileSystem &fs) {
+	auto cache_directory = GetDirectory(context, fs);
+	std::lock_guard<std::mutex> guard(lock);
+	LoadDirectory(fs, cache_directory);
+
+	idx_t removed = 0;
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (fs.TryRemoveFile(it->first)) {
+			total_size -= it->second.size;
+			it = entries.erase(it);
+			removed++;
+		} else {
+			++it;
+		}
+	}
+	return removed;
+}
+
+// =============================================================================
+// pathvariable_disk_cache() / pathvariable_clear_disk_cache()
+// =============================================================================
+
+struct PathVariableDiskCacheInfo : public TableFunctionInfo {
+	explicit PathVariableDiskCacheInfo(shared_ptr<PathVariableDiskCache> disk_cache_p)
+	    : disk_cache(std::move(disk_cache_p)) {
+	}
+	shared_ptr<PathVariableDiskCache> disk_cache;
+};
+
+struct PathVariableClearDiskCacheInfo : public ScalarFunctionInfo {
+	explicit PathVariableClearDiskCacheInfo(shared_ptr<PathVariableDiskCache> disk_cache_p)
+	    : disk_cache(std::move(disk_cache_p)) {
+	}
+	shared_ptr<PathVariableDiskCache> disk_cache;
+};
+
+struct DiskCacheBindData : public TableFunctionData {
+	vector<PathVariableDiskCache::EntryInfo> entries;
+};
+
+struct DiskCacheScanState : public GlobalTableFunctionState {
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> DiskCacheBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+	auto &info = input.info->Cast<PathVariableDiskCacheInfo>();
+	auto result = make_uniq<DiskCacheBindData>();
+	result->entries = info.disk_cache->GetEntries(context, FileSystem::GetFileSystem(context));
+
+	names = {"cache_file", "source_path", "size", "last_access"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::TIMESTAMP};
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> DiskCacheInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<DiskCacheScanState>();
+}
+
+static void DiskCacheScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<DiskCacheBindData>();
+	auto &state = data.global_state->Cast<DiskCacheScanState>();
+
+	idx_t count = 0;
+	while (state.offset < bind_data.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = bind_data.entries[state.offset++];
+		output.SetValue(0, count, Value(entry.cache_file));
+		// Files from earlier sessions have no known source
+		output.SetValue(1, count, entry.source_path.empty() ? Value(LogicalType::VARCHAR) : Value(entry.source_path));
+		output.SetValue(2, count, Value::UBIGINT(entry.size));
+		output.SetValue(3, count, Value::TIMESTAMP(entry.last_access));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+static void ClearDiskCacheFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.function.function_info->Cast<PathVariableClearDiskCacheInfo>();
+	auto &context = state.GetContext();
+
+	idx_t removed = info.disk_cache->Clear(context, FileSystem::GetFileSystem(context));
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<int64_t>(result)[0] = NumericCast<int64_t>(removed);
+}
+
+void PathVariableDiskCache::Register(ExtensionLoader &loader, shared_ptr<PathVariableDiskCache> disk_cache) {
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(DIRECTORY_SETTING,
+	                          "Directory for local copies of remote files read through pathvariable:cache: "
+	                          "(default ~/.duckdb/scalarfs_cache)",
+	                          LogicalType::VARCHAR, Value(""));
+	config.AddExtensionOption(MAX_SIZE_SETTING,
+	                          "Size budget in bytes of the pathvariable:cache: directory (0 disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_SIZE));
+
+	TableFunction list_cache("pathvariable_disk_cache", {}, DiskCacheScan, DiskCacheBind, DiskCacheInit);
+	list_cache.function_info = make_shared_ptr<PathVariableDiskCacheInfo>(disk_cache);
+	loader.RegisterFunction(list_cache);
+
+	ScalarFunction clear_cache("pathvariable_clear_disk_cache", {}, LogicalType::BIGINT, ClearDiskCacheFunction);
+	clear_cache.stability = FunctionStability::VOLATILE;
+	clear_cache.function_info = make_shared_ptr<PathVariableClearDiskCacheInfo>(std::move(disk_cache));
+	loader.RegisterFunction(clear_cache);
+}
+
+} // namespace duckdb
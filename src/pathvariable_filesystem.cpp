@@ -1,12 +1,26 @@
 #include "pathvariable_filesystem.hpp"
+#include "memory_file_handle.hpp"
+#include "pathvariable_watermark.hpp"
+#include "variable_name_index.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/hive_partitioning.hpp"
+#include "duckdb/common/numeric_utils.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/function/scalar/string_common.hpp"
 #include "duckdb/main/client_config.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "utf8proc_wrapper.hpp"
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <unordered_set>
 
 namespace duckdb {
 
@@ -15,17 +29,426 @@ namespace duckdb {
 // =============================================================================
 
 PathVariableFileHandle::PathVariableFileHandle(FileSystem &pathvar_fs, string original_path,
-                                               unique_ptr<FileHandle> underlying_handle_p, FileSystem &underlying_fs_p)
+                                               unique_ptr<FileHandle> underlying_handle_p)
     : FileHandle(pathvar_fs, std::move(original_path), underlying_handle_p->GetFlags()),
-      underlying_handle(std::move(underlying_handle_p)), underlying_fs(underlying_fs_p) {
+      underlying_handle(std::move(underlying_handle_p)), underlying_fs(underlying_handle->file_system) {
+}
+
+// Shared state of a race between candidate opens. Pool jobs pick up
+// candidates in order until one wins; opens still in flight at that point
+// are closed by their job as soon as they complete. The jobs own the state
+// together with the opening thread, so the winning handle never waits for
+// the losers.
+struct PathVariableRace {
+	std::mutex lock;
+	std::condition_variable resolved_cv;
+	vector<string> candidates;
+	vector<std::exception_ptr> errors;
+	idx_t next_candidate = 0;
+	idx_t finished = 0;
+	// Set once a candidate wins - no further candidates are started
+	bool decided = false;
+	unique_ptr<FileHandle> winner;
+};
+
+// Open a race candidate. A candidate wins once it is open AND has served its
+// first block, so a mirror that accepts the open but then stalls does not win.
+// The block is read only to prove that - it costs every candidate one read
+// request (a round trip on remote filesystems) on top of the open.
+static unique_ptr<FileHandle> OpenRaceCandidate(FileSystem &fs, const string &candidate, FileOpenFlags flags) {
+	auto handle = fs.OpenFile(candidate, flags, nullptr);
+	if (handle && handle->CanSeek()) {
+		idx_t probe_bytes = handle->GetFileSize();
+		if (probe_bytes > PathVariableFileSystem::RACE_PROBE_BYTES) {
+			probe_bytes = PathVariableFileSystem::RACE_PROBE_BYTES;
+		}
+		if (probe_bytes > 0) {
+			auto block = make_unsafe_uniq_array<data_t>(probe_bytes);
+			handle->Read(block.get(), probe_bytes, 0);
+		}
+	}
+	return handle;
+}
+
+// Captured files waiting to be stored in their variables, kept per
+// ClientContext. Handles close on whichever thread ran the scan; the variables
+// are set on the client thread when the query ends.
+struct PathVariableCaptures : public ClientContextState {
+	static shared_ptr<PathVariableCaptures> Get(ClientContext &context) {
+		return context.registered_state->GetOrCreate<PathVariableCaptures>("scalarfs_pathvariable_captures");
+	}
+
+	void Add(const string &variable_name, string bytes) {
+		std::lock_guard<std::mutex> guard(lock);
+		pending.emplace_back(variable_name, std::move(bytes));
+	}
+
+	void QueryEnd(ClientContext &context) override {
+		vector<pair<string, string>> captured;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			std::swap(captured, pending);
+		}
+		// In close order, so the last read of a variable wins
+		auto &config = ClientConfig::GetConfig(context);
+		for (auto &entry : captured) {
+			auto &bytes = entry.second;
+			// VARCHAR when the bytes are text, BLOB otherwise (as variable: writes)
+			if (memchr(bytes.data(), '\0', bytes.size()) == nullptr &&
+			    Utf8Proc::Analyze(bytes.data(), bytes.size()) != UnicodeType::INVALID) {
+				config.SetUserVariable(entry.first, Value(std::move(bytes)));
+			} else {
+				config.SetUserVariable(entry.first, Value::BLOB(const_data_ptr_cast(bytes.data()), bytes.size()));
+			}
+			VariableNameIndex::NotifySet(context, entry.first);
+		}
+	}
+
+	std::mutex lock;
+	vector<pair<string, string>> pending;
+};
+
+// Bytes read through a capture handle, kept as the ranges of the file they
+// cover - only what was read is held, wherever in the file it was read.
+// Readers may skip parts of a file (Parquet reads the footer and the
+// projected columns only): such a partial read is not kept, unless the
+// capture is full - then the skipped ranges are read when the handle closes.
+// A capture that would hold more than max_size bytes is given up.
+struct PathVariableCapture {
+	PathVariableCapture(shared_ptr<PathVariableCaptures> captures_p, string variable_name_p, idx_t file_size_p,
+	                    bool full_p, idx_t max_size_p)
+	    : captures(std::move(captures_p)), variable_name(std::move(variable_name_p)), file_size(file_size_p),
+	      full(full_p), max_size(max_size_p), abandoned(file_size_p > max_size_p) {
+	}
+
+	void Record(const void *data, idx_t size, idx_t location) {
+		if (size == 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		idx_t start = location;
+		idx_t end = location + size;
+		furthest = MaxValue<idx_t>(furthest, end);
+		if (abandoned) {
+			return;
+		}
+		auto bytes = const_char_ptr_cast(data);
+
+		// Extend the chunk that reaches start (sequential reads append to it),
+		// or start a new one
+		auto next = chunks.upper_bound(start);
+		auto chunk = chunks.end();
+		if (next != chunks.begin()) {
+			auto previous = std::prev(next);
+			if (previous->first + previous->second.size() >= start) {
+				chunk = previous;
+			}
+		}
+		if (chunk == chunks.end()) {
+			chunk = chunks.emplace(start, string()).first;
+		}
+		auto &chunk_bytes = chunk->second;
+		idx_t offset = start - chunk->first;
+		if (offset + size > chunk_bytes.size()) {
+			captured += offset + size - chunk_bytes.size();
+			chunk_bytes.resize(offset + size);
+		}
+		memcpy(&chunk_bytes[offset], bytes, size);
+
+		// Absorb the chunks the range now reaches
+		next = std::next(chunk);
+		while (next != chunks.end() && next->first <= chunk->first + chunk_bytes.size()) {
+			idx_t chunk_end = chunk->first + chunk_bytes.size();
+			idx_t next_end = next->first + next->second.size();
+			if (next_end > chunk_end) {
+				chunk_bytes.append(next->second, chunk_end - next->first, string::npos);
+			}
+			captured -= next->second.size() - (next_end > chunk_end ? next_end - chunk_end : 0);
+			next = chunks.erase(next);
+		}
+
+		if (captured > max_size) {
+			Abandon();
+		}
+	}
+
+	idx_t Size() {
+		std::lock_guard<std::mutex> guard(lock);
+		return furthest;
+	}
+
+	// Hand the bytes over to be stored in the variable at query end, if they
+	// are the whole file (reading the ranges nobody read for a full capture)
+	void Finish(FileHandle &handle) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (finished) {
+			return;
+		}
+		finished = true;
+		idx_t size = MaxValue<idx_t>(file_size, furthest);
+		if (abandoned || size > max_size) {
+			Abandon();
+			return;
+		}
+		bool complete = chunks.size() == 1 && chunks.begin()->first == 0 && chunks.begin()->second.size() == size;
+		if (!complete && (!full || !handle.CanSeek())) {
+			// Not read to the end - there is no complete copy
+			Abandon();
+			return;
+		}
+
+		string buffer;
+		if (!chunks.empty() && chunks.begin()->first == 0) {
+			// Usually the whole file, read from the start
+			buffer = std::move(chunks.begin()->second);
+			chunks.erase(chunks.begin());
+		}
+		idx_t position = buffer.size();
+		buffer.resize(size);
+		while (position < size) {
+			auto chunk = chunks.begin();
+			idx_t gap_end = chunk == chunks.end() ? size : chunk->first;
+			if (gap_end > position) {
+				handle.Read(&buffer[position], gap_end - position, position);
+				position = gap_end;
+			}
+			if (chunk != chunks.end()) {
+				memcpy(&buffer[position], chunk->second.data(), chunk->second.size());
+				position += chunk->second.size();
+				chunks.erase(chunk);
+			}
+		}
+		captured = 0;
+		captures->Add(variable_name, std::move(buffer));
+	}
+
+	// Drop the bytes - the variable is left as it was (lock held)
+	void Abandon() {
+		abandoned = true;
+		chunks.clear();
+		captured = 0;
+	}
+
+	shared_ptr<PathVariableCaptures> captures;
+	string variable_name;
+	// Size of the file when it was opened (0 if the handle cannot tell)
+	idx_t file_size;
+	bool full;
+	idx_t max_size;
+	std::mutex lock;
+	// Bytes read, by the offset they start at; chunks neither overlap nor touch
+	std::map<idx_t, string> chunks;
+	// Bytes held in chunks
+	idx_t captured = 0;
+	// One past the furthest byte read (kept when abandoned: a stream's position)
+	idx_t furthest = 0;
+	bool abandoned;
+	bool finished = false;
+};
+
+PathVariableFileHandle::~PathVariableFileHandle() {
+	if (capture && underlying_handle) {
+		try {
+			capture->Finish(*underlying_handle);
+		} catch (...) {
+			// The read failed - no snapshot, the handle goes away regardless
+		}
+	}
+	if (shard) {
+		shard->RecordClose(shard_target);
+	}
 }
 
 void PathVariableFileHandle::Close() {
-	if (underlying_handle) {
-		underlying_handle->Close();
+	// The file is closed (and the shard released) even when reading the rest
+	// of a full capture fails; that error is reported after
+	std::exception_ptr capture_error;
+	if (capture && underlying_handle) {
+		try {
+			capture->Finish(*underlying_handle);
+		} catch (...) {
+			capture_error = std::current_exception();
+		}
+	}
+	try {
+		if (underlying_handle) {
+			underlying_handle->Close();
+		}
+	} catch (...) {
+		if (shard) {
+			shard->RecordClose(shard_target);
+			shard = nullptr;
+		}
+		throw;
+	}
+	if (shard) {
+		shard->RecordClose(shard_target);
+		shard = nullptr;
+	}
+	if (capture_error) {
+		std::rethrow_exception(capture_error);
+	}
+}
+
+void PathVariableFileHandle::SetShard(shared_ptr<PathVariableShardState> shard_p, idx_t shard_target_p) {
+	shard = std::move(shard_p);
+	shard_target = shard_target_p;
+}
+
+void PathVariableFileHandle::RecordWrite(idx_t bytes) {
+	if (shard) {
+		shard->RecordWrite(shard_target, bytes);
+	}
+}
+
+void PathVariableFileHandle::SetCapture(unique_ptr<PathVariableCapture> capture_p) {
+	capture = std::move(capture_p);
+}
+
+idx_t PathVariableFileHandle::CapturedSize() {
+	return capture ? capture->Size() : 0;
+}
+
+void PathVariableFileHandle::RecordRead(const void *buffer, idx_t nr_bytes, idx_t location) {
+	if (capture) {
+		capture->Record(buffer, nr_bytes, location);
+	}
+}
+
+// =============================================================================
+// PathVariableShardState Implementation
+// =============================================================================
+
+idx_t PathVariableShardState::Assign(PathVariableShardMode mode) {
+	std::lock_guard<std::mutex> guard(lock);
+	idx_t target = 0;
+	if (mode == PathVariableShardMode::ROUND_ROBIN) {
+		target = next_target;
+		next_target = (next_target + 1) % bytes_written.size();
+	} else {
+		// Fewest bytes written; files opened at the same time (nothing written
+		// yet) are spread by their open file count
+		for (idx_t i = 1; i < bytes_written.size(); i++) {
+			if (bytes_written[i] < bytes_written[target] ||
+			    (bytes_written[i] == bytes_written[target] && open_files[i] < open_files[target])) {
+				target = i;
+			}
+		}
+	}
+	open_files[target]++;
+	return target;
+}
+
+void PathVariableShardState::RecordWrite(idx_t target, idx_t bytes) {
+	std::lock_guard<std::mutex> guard(lock);
+	bytes_written[target] += bytes;
+}
+
+void PathVariableShardState::RecordClose(idx_t target) {
+	std::lock_guard<std::mutex> guard(lock);
+	if (open_files[target] > 0) {
+		open_files[target]--;
 	}
 }
 
+// =============================================================================
+// PathVariableHandleFileSystem Implementation
+// =============================================================================
+
+PathVariableHandleFileSystem::PathVariableHandleFileSystem(bool can_seek_p) : can_seek(can_seek_p) {
+}
+
+string PathVariableHandleFileSystem::GetName() const {
+	return "PathVariableHandleFileSystem";
+}
+
+void PathVariableHandleFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().Read(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes, location);
+	pv_handle.RecordRead(buffer, NumericCast<idx_t>(nr_bytes), location);
+}
+
+int64_t PathVariableHandleFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	auto &underlying_fs = pv_handle.GetUnderlyingFileSystem();
+	if (!pv_handle.IsCapturing()) {
+		return underlying_fs.Read(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes);
+	}
+	// A stream has no position to ask for - its reads follow one another
+	auto &underlying_handle = pv_handle.GetUnderlyingHandle();
+	auto location =
+	    underlying_handle.CanSeek() ? underlying_fs.SeekPosition(underlying_handle) : pv_handle.CapturedSize();
+	auto bytes_read = underlying_fs.Read(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes);
+	if (bytes_read > 0) {
+		pv_handle.RecordRead(buffer, NumericCast<idx_t>(bytes_read), location);
+	}
+	return bytes_read;
+}
+
+void PathVariableHandleFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().Write(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes, location);
+	pv_handle.RecordWrite(NumericCast<idx_t>(nr_bytes));
+}
+
+int64_t PathVariableHandleFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	auto written = pv_handle.GetUnderlyingFileSystem().Write(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes);
+	if (written > 0) {
+		pv_handle.RecordWrite(NumericCast<idx_t>(written));
+	}
+	return written;
+}
+
+int64_t PathVariableHandleFileSystem::GetFileSize(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	return pv_handle.GetUnderlyingFileSystem().GetFileSize(pv_handle.GetUnderlyingHandle());
+}
+
+void PathVariableHandleFileSystem::Seek(FileHandle &handle, idx_t location) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().Seek(pv_handle.GetUnderlyingHandle(), location);
+}
+
+idx_t PathVariableHandleFileSystem::SeekPosition(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	return pv_handle.GetUnderlyingFileSystem().SeekPosition(pv_handle.GetUnderlyingHandle());
+}
+
+void PathVariableHandleFileSystem::Reset(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().Reset(pv_handle.GetUnderlyingHandle());
+}
+
+bool PathVariableHandleFileSystem::CanSeek() {
+	return can_seek;
+}
+
+bool PathVariableHandleFileSystem::OnDiskFile(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	return pv_handle.GetUnderlyingFileSystem().OnDiskFile(pv_handle.GetUnderlyingHandle());
+}
+
+void PathVariableHandleFileSystem::Truncate(FileHandle &handle, int64_t new_size) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().Truncate(pv_handle.GetUnderlyingHandle(), new_size);
+}
+
+void PathVariableHandleFileSystem::FileSync(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	pv_handle.GetUnderlyingFileSystem().FileSync(pv_handle.GetUnderlyingHandle());
+}
+
+timestamp_t PathVariableHandleFileSystem::GetLastModifiedTime(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	return pv_handle.GetUnderlyingFileSystem().GetLastModifiedTime(pv_handle.GetUnderlyingHandle());
+}
+
+string PathVariableHandleFileSystem::GetVersionTag(FileHandle &handle) {
+	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
+	return pv_handle.GetUnderlyingFileSystem().GetVersionTag(pv_handle.GetUnderlyingHandle());
+}
+
 // =============================================================================
 // PathVariableFileSystem Implementation
 // =============================================================================
@@ -43,9 +466,8 @@ bool PathVariableFileSystem::IsTempPath(const string &path) {
 }
 
 string PathVariableFileSystem::ExtractVariableName(const string &path) {
-	// Use the parser to extract variable name (handles modifiers)
-	auto parsed = PathVariableParser::Parse(path);
-	return parsed.variable_name;
+	// Use the parser to extract variable name (handles modifiers); memoized per path
+	return compile_cache.Compile(path)->parsed.variable_name;
 }
 
 string PathVariableFileSystem::ComputeTempPath(const string &target_path) {
@@ -64,6 +486,148 @@ string PathVariableFileSystem::ComputeTempPath(const string &target_path) {
 	return dir + "tmp_" + filename;
 }
 
+bool PathVariableFileSystem::IsPathType(const LogicalType &type) {
+	if (type.id() == LogicalTypeId::VARCHAR || type.id() == LogicalTypeId::BLOB) {
+		return true;
+	}
+	if (type.id() != LogicalTypeId::STRUCT) {
+		return false;
+	}
+	// Path records, e.g. rows of a file catalog written with FORMAT variable
+	for (auto &field : StructType::GetChildTypes(type)) {
+		if (StringUtil::CIEquals(field.first, "path")) {
+			return field.second.id() == LogicalTypeId::VARCHAR || field.second.id() == LogicalTypeId::BLOB;
+		}
+	}
+	return false;
+}
+
+bool PathVariableFileSystem::GetSizeFromValue(const Value &value, idx_t &size) {
+	if (value.IsNull() || value.type().id() != LogicalTypeId::STRUCT) {
+		return false;
+	}
+	auto &fields = StructType::GetChildTypes(value.type());
+	auto &children = StructValue::GetChildren(value);
+	for (idx_t i = 0; i < fields.size(); i++) {
+		if (!StringUtil::CIEquals(fields[i].first, "size") && !StringUtil::CIEquals(fields[i].first, "file_size")) {
+			continue;
+		}
+		if (children[i].IsNull() || !fields[i].second.IsIntegral()) {
+			return false;
+		}
+		auto record_size = children[i].GetValue<int64_t>();
+		if (record_size < 0) {
+			return false;
+		}
+		size = NumericCast<idx_t>(record_size);
+		return true;
+	}
+	return false;
+}
+
+bool PathVariableFileSystem::RecordMatches(const vector<PathVariablePredicate> &predicates,
+                                           const vector<Value> &operands, const Value &record) {
+	if (record.type().id() != LogicalTypeId::STRUCT) {
+		return true;
+	}
+	auto &fields = StructType::GetChildTypes(record.type());
+	auto &children = StructValue::GetChildren(record);
+	for (idx_t p = 0; p < predicates.size(); p++) {
+		for (idx_t i = 0; i < fields.size(); i++) {
+			if (!StringUtil::CIEquals(fields[i].first, predicates[p].field)) {
+				continue;
+			}
+			// Compared in the field's type, e.g. a TIMESTAMP field with '2026-01-01'
+			Value operand;
+			string error;
+			if (!operands[p].DefaultTryCastAs(fields[i].second, operand, &error)) {
+				throw InvalidInputException("Invalid pathvariable: where value '%s' cannot be compared with field "
+				                            "'%s' of type %s",
+				                            operands[p].ToString(), fields[i].first, fields[i].second.ToString());
+			}
+			if (!predicates[p].Matches(children[i], operand)) {
+				return false;
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+bool PathVariableFileSystem::HiveKeysMatch(const vector<PathVariablePredicate> &predicates,
+                                           const vector<Value> &operands, const string &path) {
+	auto keys = HivePartitioning::Parse(path);
+	if (keys.empty()) {
+		return true;
+	}
+	for (idx_t p = 0; p < predicates.size(); p++) {
+		for (auto &key : keys) {
+			if (!StringUtil::CIEquals(key.first, predicates[p].field)) {
+				continue;
+			}
+			// Hive values are strings: compared in the type of a variable operand,
+			// numerically when both sides are numbers, as strings otherwise
+			Value key_value(key.second);
+			Value operand = operands[p];
+			if (operand.type().id() != LogicalTypeId::VARCHAR) {
+				Value typed_value;
+				if (!key_value.DefaultTryCastAs(operand.type(), typed_value, nullptr)) {
+					break;
+				}
+				key_value = std::move(typed_value);
+			} else {
+				Value key_number;
+				Value operand_number;
+				if (key_value.DefaultTryCastAs(LogicalType::DOUBLE, key_number, nullptr) &&
+				    operand.DefaultTryCastAs(LogicalType::DOUBLE, operand_number, nullptr)) {
+					key_value = std::move(key_number);
+					operand = std::move(operand_number);
+				}
+			}
+			if (!predicates[p].Matches(key_value, operand)) {
+				return false;
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+bool PathVariableFileSystem::GetListedFileSize(const OpenFileInfo &info, idx_t &size) {
+	// Remote filesystems (e.g. httpfs) attach the size found while listing
+	if (!info.extended_info) {
+		return false;
+	}
+	auto entry = info.extended_info->options.find("file_size");
+	if (entry == info.extended_info->options.end() || entry->second.IsNull()) {
+		return false;
+	}
+	size = entry->second.GetValue<idx_t>();
+	return true;
+}
+
+bool PathVariableFileSystem::GetPathFromValue(const Value &value, string &path) {
+	if (value.IsNull()) {
+		return false;
+	}
+	if (value.type().id() != LogicalTypeId::STRUCT) {
+		path = value.ToString();
+		return true;
+	}
+	auto &fields = StructType::GetChildTypes(value.type());
+	auto &children = StructValue::GetChildren(value);
+	for (idx_t i = 0; i < fields.size(); i++) {
+		if (StringUtil::CIEquals(fields[i].first, "path")) {
+			if (children[i].IsNull()) {
+				return false;
+			}
+			path = children[i].ToString();
+			return true;
+		}
+	}
+	return false;
+}
+
 string PathVariableFileSystem::GetPathFromVariable(const string &var_name, optional_ptr<FileOpener> opener) {
 	auto context = FileOpener::TryGetClientContext(opener);
 	if (!context) {
@@ -82,9 +646,9 @@ string PathVariableFileSystem::GetPathFromVariable(const string &var_name, optio
 	// Type validation: must be VARCHAR or BLOB (or list of those for read operations)
 	auto &type = result.type();
 	if (type.id() == LogicalTypeId::LIST) {
-		// Check if it's a valid list type (VARCHAR[] or BLOB[])
+		// Check if it's a valid list type (VARCHAR[], BLOB[] or a list of path records)
 		auto &child_type = ListType::GetChildType(type);
-		if (child_type.id() == LogicalTypeId::VARCHAR || child_type.id() == LogicalTypeId::BLOB) {
+		if (IsPathType(child_type)) {
 			// Valid list type - supported for reading via Glob, but not for single-file operations
 			throw IOException("Variable '%s' is a list type (%s). List variables are supported for reading "
 			                  "(e.g., read_csv, read_json), but not for single-file write operations. "
@@ -92,16 +656,22 @@ string PathVariableFileSystem::GetPathFromVariable(const string &var_name, optio
 			                  var_name, type.ToString());
 		} else {
 			// Invalid list child type
-			throw IOException("Variable '%s' is a list but child type must be VARCHAR or BLOB, got %s", var_name,
-			                  type.ToString());
+			throw IOException("Variable '%s' is a list but child type must be VARCHAR or BLOB (or a STRUCT with a "
+			                  "'path' field), got %s",
+			                  var_name, type.ToString());
 		}
 	}
-	if (type.id() != LogicalTypeId::VARCHAR && type.id() != LogicalTypeId::BLOB) {
-		throw IOException("Variable '%s' must be VARCHAR or BLOB type to be used as a path, got %s", var_name,
-		                  type.ToString());
+	if (!IsPathType(type)) {
+		throw IOException("Variable '%s' must be VARCHAR or BLOB type (or a STRUCT with a 'path' field) to be used "
+		                  "as a path, got %s",
+		                  var_name, type.ToString());
 	}
 
-	return result.ToString();
+	string path;
+	if (!GetPathFromValue(result, path)) {
+		throw IOException("Variable '%s' has a NULL path", var_name);
+	}
+	return path;
 }
 
 bool PathVariableFileSystem::IsListVariable(const string &var_name, optional_ptr<FileOpener> opener) {
@@ -139,32 +709,38 @@ vector<string> PathVariableFileSystem::GetPathsFromVariable(const string &var_na
 
 	auto &type = result.type();
 
-	// Handle list types (VARCHAR[] or BLOB[])
+	// Handle list types (VARCHAR[], BLOB[] or a list of path records)
 	if (type.id() == LogicalTypeId::LIST) {
 		auto &child_type = ListType::GetChildType(type);
-		if (child_type.id() != LogicalTypeId::VARCHAR && child_type.id() != LogicalTypeId::BLOB) {
-			throw IOException("Variable '%s' is a list but child type must be VARCHAR or BLOB, got %s[]", var_name,
-			                  child_type.ToString());
+		if (!IsPathType(child_type)) {
+			throw IOException("Variable '%s' is a list but child type must be VARCHAR or BLOB (or a STRUCT with a "
+			                  "'path' field), got %s[]",
+			                  var_name, child_type.ToString());
 		}
 
 		vector<string> paths;
 		auto &children = ListValue::GetChildren(result);
 		for (const auto &child : children) {
-			if (child.IsNull()) {
+			string path;
+			if (!GetPathFromValue(child, path)) {
 				throw IOException("Variable '%s' contains NULL element in list", var_name);
 			}
-			paths.push_back(child.ToString());
+			paths.push_back(std::move(path));
 		}
 		return paths;
 	}
 
-	// Handle scalar types (VARCHAR or BLOB)
-	if (type.id() != LogicalTypeId::VARCHAR && type.id() != LogicalTypeId::BLOB) {
+	// Handle scalar types (VARCHAR, BLOB or a path record)
+	if (!IsPathType(type)) {
 		throw IOException("Variable '%s' must be VARCHAR, BLOB, or a list of these types, got %s", var_name,
 		                  type.ToString());
 	}
 
-	return {result.ToString()};
+	string path;
+	if (!GetPathFromValue(result, path)) {
+		throw IOException("Variable '%s' has a NULL path", var_name);
+	}
+	return {path};
 }
 
 string PathVariableFileSystem::ResolvePath(const string &path, optional_ptr<FileOpener> opener) {
@@ -189,6 +765,30 @@ FileSystem &PathVariableFileSystem::GetParentFileSystem(optional_ptr<FileOpener>
 
 unique_ptr<FileHandle> PathVariableFileSystem::OpenFile(const string &path, FileOpenFlags flags,
                                                         optional_ptr<FileOpener> opener) {
+	if (PathVariablePrefetcher::IsPrefetchedPath(path)) {
+		return OpenPrefetched(path, flags, opener);
+	}
+	string cached_target;
+	if (PathVariableDiskCache::ParseCachedPath(path, cached_target)) {
+		// A remote file of a cache glob: downloaded (or found) now that it is read
+		auto &parent_fs = GetParentFileSystem(opener);
+		if (!flags.OpenForWriting()) {
+			auto context = FileOpener::TryGetClientContext(opener);
+			cached_target = disk_cache->Materialize(*context, parent_fs, cached_target);
+		}
+		return parent_fs.OpenFile(cached_target, flags, nullptr);
+	}
+	auto compiled = compile_cache.Compile(path);
+	if (compiled->pipeline.shard) {
+		return OpenShard(path, compiled->pipeline, flags, opener);
+	}
+	if (compiled->pipeline.capture) {
+		return OpenCapture(path, compiled->pipeline, flags, opener);
+	}
+	if (compiled->pipeline.race) {
+		return OpenRace(path, compiled->pipeline, flags, opener);
+	}
+
 	// Resolve the actual file path from the variable
 	string resolved_path = ResolvePath(path, opener);
 
@@ -196,18 +796,380 @@ unique_ptr<FileHandle> PathVariableFileSystem::OpenFile(const string &path, File
 	// Note: GetParentFileSystem returns an OpenerFileSystem which already has context,
 	// so we pass nullptr for the opener to avoid "cannot take an opener" errors
 	auto &parent_fs = GetParentFileSystem(opener);
-	auto underlying_handle = parent_fs.OpenFile(resolved_path, flags, nullptr);
+	if (compiled->pipeline.disk_cache && !flags.OpenForWriting()) {
+		auto context = FileOpener::TryGetClientContext(opener);
+		resolved_path = disk_cache->Materialize(*context, parent_fs, resolved_path);
+	}
+	auto handle = parent_fs.OpenFile(resolved_path, flags, nullptr);
+	if (flags.OpenForWriting()) {
+		missing_cache->Invalidate(resolved_path);
+	}
+
+	// Nothing to observe on the handle: hand out the target's own, so capability
+	// queries (CanSeek, OnDiskFile, ...) reach its filesystem
+	return handle;
+}
+
+unique_ptr<FileHandle> PathVariableFileSystem::WrapHandle(const string &path, unique_ptr<FileHandle> handle) {
+	// DuckDB asks the handle's filesystem whether it can seek, without the handle
+	auto &handle_fs = handle->CanSeek() ? seekable_handle_fs : stream_handle_fs;
+	return make_uniq<PathVariableFileHandle>(handle_fs, path, std::move(handle));
+}
+
+unique_ptr<FileHandle> PathVariableFileSystem::OpenCapture(const string &path, const PathVariablePipeline &pipeline,
+                                                           FileOpenFlags flags, optional_ptr<FileOpener> opener) {
+	if (flags.OpenForWriting()) {
+		throw IOException("Cannot write to '%s': the pathvariable: capture modifier only supports reading", path);
+	}
+	auto context = FileOpener::TryGetClientContext(opener);
+	if (!context) {
+		throw IOException("Cannot capture '%s' without client context", path);
+	}
+
+	unique_ptr<FileHandle> handle;
+	if (pipeline.race) {
+		handle = OpenRace(path, pipeline, flags, opener);
+	} else {
+		// The file the other modifiers resolve to (search, append, ...)
+		auto files = ExpandPath(path, opener.get());
+		if (files.size() == 1 && files[0].path == path) {
+			// The variable does not resolve - report it as a plain open would
+			files[0].path = ResolvePath(path, opener);
+		}
+		if (files.size() != 1) {
+			throw IOException("pathvariable: capture needs a path that resolves to one file, '%s' resolves to %d",
+			                  path, files.size());
+		}
+		auto &parent_fs = GetParentFileSystem(opener);
+		if (pipeline.disk_cache) {
+			files[0].path = disk_cache->Materialize(*context, parent_fs, files[0].path);
+		}
+		handle = parent_fs.OpenFile(files[0].path, flags, nullptr);
+	}
+	if (!handle) {
+		return nullptr;
+	}
+	auto file_size = handle->CanSeek() ? handle->GetFileSize() : 0;
+	auto result = WrapHandle(path, std::move(handle));
+	auto &pv_handle = result->Cast<PathVariableFileHandle>();
+	pv_handle.SetCapture(make_uniq<PathVariableCapture>(PathVariableCaptures::Get(*context),
+	                                                    pipeline.capture_variable, file_size, pipeline.capture_full,
+	                                                    GetCaptureMaxSize(*context)));
+	return result;
+}
+
+unique_ptr<FileHandle> PathVariableFileSystem::OpenPrefetched(const string &path, FileOpenFlags flags,
+                                                              optional_ptr<FileOpener> opener) {
+	string target_path;
+	if (!PathVariablePrefetcher::ParsePrefetchedPath(path, target_path)) {
+		throw IOException("Invalid prefetched pathvariable: path '%s'", path);
+	}
+	auto context = FileOpener::TryGetClientContext(opener);
+	string data;
+	if (context && !flags.OpenForWriting() && PathVariablePrefetcher::Get(*context).Take(target_path, data)) {
+		return make_uniq<MemoryFileHandle>(memory_fs, target_path, std::move(data));
+	}
+	// Not fetched (yet): read it directly
+	auto &parent_fs = GetParentFileSystem(opener);
+	return parent_fs.OpenFile(target_path, flags, nullptr);
+}
+
+bool PathVariableFileSystem::IsShardPath(const string &path) {
+	return PathVariableParser::CanHandle(path) && compile_cache.Compile(path)->pipeline.shard;
+}
+
+vector<string> PathVariableFileSystem::GetShardTargets(const string &path, optional_ptr<FileOpener> opener,
+                                                       string &relative) {
+	// pathvariable:shard:targets/part=1/data_0.csv -> variable "targets", relative "part=1/data_0.csv"
+	auto &name = compile_cache.Compile(path)->parsed.variable_name;
+	auto sep_pos = name.find_first_of("/\\");
+	string var_name = name.substr(0, sep_pos);
+	relative = sep_pos == string::npos ? string() : name.substr(sep_pos + 1);
+
+	auto targets = GetPathsFromVariable(var_name, opener);
+	if (targets.empty()) {
+		throw IOException("Variable '%s' has no shard targets", var_name);
+	}
+	return targets;
+}
+
+shared_ptr<PathVariableShardState> PathVariableFileSystem::GetShardState(const vector<string> &targets) {
+	auto key = StringUtil::Join(targets, "\n");
+	std::lock_guard<std::mutex> guard(shard_lock);
+	auto entry = shard_states.find(key);
+	if (entry != shard_states.end()) {
+		return entry->second;
+	}
+	if (shard_states.size() >= MAX_SHARD_STATES) {
+		// Handles still writing keep their state alive
+		shard_states.clear();
+	}
+	auto state = make_shared_ptr<PathVariableShardState>(targets.size());
+	shard_states.emplace(std::move(key), state);
+	return state;
+}
+
+unique_ptr<FileHandle> PathVariableFileSystem::OpenShard(const string &path, const PathVariablePipeline &pipeline,
+                                                         FileOpenFlags flags, optional_ptr<FileOpener> opener) {
+	auto &parent_fs = GetParentFileSystem(opener);
+	string relative;
+	auto targets = GetShardTargets(path, opener, relative);
+	if (relative.empty()) {
+		throw IOException("'%s' is a shard directory - write below it with PER_THREAD_OUTPUT, FILE_SIZE_BYTES or "
+		                  "PARTITION_BY",
+		                  path);
+	}
+
+	if (!flags.OpenForWriting()) {
+		// Reading back: the first target that has the file
+		string target_path = PathVariablePipeline::JoinPaths(targets[0], relative);
+		for (auto &target : targets) {
+			auto candidate = PathVariablePipeline::JoinPaths(target, relative);
+			if (parent_fs.FileExists(candidate, nullptr)) {
+				target_path = std::move(candidate);
+				break;
+			}
+		}
+		return parent_fs.OpenFile(target_path, flags, nullptr);
+	}
+
+	auto shard = GetShardState(targets);
+	auto target = shard->Assign(pipeline.shard_mode);
+	auto target_path = PathVariablePipeline::JoinPaths(targets[target], relative);
+	unique_ptr<FileHandle> handle;
+	try {
+		handle = parent_fs.OpenFile(target_path, flags, nullptr);
+	} catch (...) {
+		shard->RecordClose(target);
+		throw;
+	}
+	missing_cache->Invalidate(target_path);
 
-	// Wrap in our handle type
-	return make_uniq<PathVariableFileHandle>(*this, path, std::move(underlying_handle), parent_fs);
+	auto result = WrapHandle(path, std::move(handle));
+	result->Cast<PathVariableFileHandle>().SetShard(std::move(shard), target);
+	return result;
 }
 
-void PathVariableFileSystem::ClearCache() {
-	std::lock_guard<std::mutex> lock(cache_mutex);
-	glob_cache.clear();
+unique_ptr<FileHandle> PathVariableFileSystem::OpenRace(const string &path, const PathVariablePipeline &pipeline,
+                                                        FileOpenFlags flags, optional_ptr<FileOpener> opener) {
+	if (flags.OpenForWriting()) {
+		throw IOException("Cannot write to '%s': the pathvariable: race modifier only supports reading", path);
+	}
+	auto &parent_fs = GetParentFileSystem(opener);
+	auto context = FileOpener::TryGetClientContext(opener);
+
+	// The candidates are the glob result without the race step, in source order
+	auto race = make_shared_ptr<PathVariableRace>();
+	auto &state = *race;
+	for (auto &info : ExpandPath(path, opener.get())) {
+		if (info.path == path) {
+			// ExpandPath hands back the path itself when the variable does not resolve
+			continue;
+		}
+		state.candidates.push_back(std::move(info.path));
+	}
+	if (pipeline.race_count > 0 && state.candidates.size() > pipeline.race_count) {
+		state.candidates.resize(pipeline.race_count);
+	}
+	if (state.candidates.empty()) {
+		throw IOException("pathvariable: race found no candidates for '%s'", path);
+	}
+	idx_t count = state.candidates.size();
+	state.errors.resize(count);
+
+	idx_t thread_count = MinValue<idx_t>(GetIOParallelism(*context), count);
+
+#ifndef DUCKDB_NO_THREADS
+	if (thread_count > 1) {
+		// Jobs may outlive this call (a loser still opening); they open through
+		// the context's filesystem while the context is alive
+		weak_ptr<ClientContext> weak_context = context->shared_from_this();
+		auto worker = [race, weak_context, flags, count]() {
+			auto &state = *race;
+			while (true) {
+				idx_t i;
+				{
+					std::lock_guard<std::mutex> guard(state.lock);
+					if (state.decided || state.next_candidate >= count) {
+						return;
+					}
+					i = state.next_candidate++;
+				}
+				unique_ptr<FileHandle> handle;
+				std::exception_ptr error;
+				auto client_context = weak_context.lock();
+				if (client_context) {
+					try {
+						handle = OpenRaceCandidate(FileSystem::GetFileSystem(*client_context), state.candidates[i],
+						                           flags);
+					} catch (...) {
+						error = std::current_exception();
+					}
+				}
+				unique_ptr<FileHandle> loser;
+				{
+					std::lock_guard<std::mutex> guard(state.lock);
+					state.finished++;
+					if (handle && !state.decided) {
+						state.decided = true;
+						state.winner = std::move(handle);
+					} else {
+						loser = std::move(handle);
+						state.errors[i] = std::move(error);
+					}
+				}
+				state.resolved_cv.notify_one();
+				if (loser) {
+					try {
+						loser->Close();
+					} catch (...) {
+					}
+				}
+			}
+		};
+		// Each worker gets a thread of its own: a loser stalled on a mirror
+		// must not hold a pool thread that prefetches and later races wait for
+		idx_t started = 0;
+		for (idx_t t = 0; t < thread_count; t++) {
+			if (io_pool->StartDetached(worker)) {
+				started++;
+			}
+		}
+
+		if (started > 0) {
+			unique_ptr<FileHandle> winner;
+			vector<std::exception_ptr> errors;
+			{
+				std::unique_lock<std::mutex> guard(state.lock);
+				state.resolved_cv.wait(guard, [&]() { return state.winner || state.finished == count; });
+				winner = std::move(state.winner);
+				if (!winner) {
+					errors = state.errors;
+				}
+			}
+			if (winner) {
+				return winner;
+			}
+			// Every candidate failed
+			for (auto &error : errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+			return nullptr;
+		}
+		// As many race threads as allowed are still running (stalled mirrors):
+		// open the candidates in order instead
+	}
+#endif
+
+	// Sequential fallback: the first candidate that opens wins
+	std::exception_ptr first_error;
+	for (auto &candidate : state.candidates) {
+		try {
+			auto handle = OpenRaceCandidate(parent_fs, candidate, flags);
+			if (handle) {
+				return handle;
+			}
+		} catch (...) {
+			if (!first_error) {
+				first_error = std::current_exception();
+			}
+		}
+	}
+	if (first_error) {
+		std::rethrow_exception(first_error);
+	}
+	return nullptr;
 }
 
 vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener *opener) {
+	if (!CanHandleFile(path)) {
+		return {};
+	}
+	if (PathVariablePrefetcher::IsPrefetchedPath(path) || PathVariableDiskCache::IsCachedPath(path)) {
+		return {OpenFileInfo(path)};
+	}
+	auto compiled = compile_cache.Compile(path);
+	// With race, the candidates are resolved and raced when the file is opened;
+	// a capture is one file, opened through a capturing handle
+	if (compiled->pipeline.race || compiled->pipeline.capture) {
+		return {OpenFileInfo(path)};
+	}
+	if (compiled->pipeline.shard) {
+		// Reading back a shard directory: the pattern below every target
+		string relative;
+		auto targets = GetShardTargets(path, opener, relative);
+		auto &parent_fs = GetParentFileSystem(opener);
+		auto context = FileOpener::TryGetClientContext(opener);
+		vector<vector<OpenFileInfo>> expanded(targets.size());
+		RunConcurrently(targets.size(), GetIOParallelism(*context), [&](idx_t i) {
+			auto target_path = PathVariablePipeline::JoinPaths(targets[i], relative);
+			if (FileSystem::HasGlob(target_path)) {
+				expanded[i] = parent_fs.Glob(target_path, nullptr);
+			} else if (parent_fs.FileExists(target_path, nullptr)) {
+				expanded[i].emplace_back(std::move(target_path));
+			}
+		});
+		vector<OpenFileInfo> result;
+		for (auto &files : expanded) {
+			for (auto &info : files) {
+				result.push_back(std::move(info));
+			}
+		}
+		std::sort(result.begin(), result.end(),
+		          [](const OpenFileInfo &a, const OpenFileInfo &b) { return a.path < b.path; });
+		return result;
+	}
+	auto result = ExpandPath(path, opener);
+	if (compiled->pipeline.disk_cache) {
+		// Remote files keep their path, behind a prefix that routes the open
+		// back here - the download happens when (and if) a file is read
+		for (auto &info : result) {
+			if (PathVariableDiskCache::IsRemotePath(info.path)) {
+				info.path = PathVariableDiskCache::GetCachedPath(info.path);
+			}
+		}
+	}
+	if (compiled->pipeline.prefetch) {
+		StartPrefetch(compiled->pipeline, result, opener);
+	}
+	return result;
+}
+
+void PathVariableFileSystem::StartPrefetch(const PathVariablePipeline &pipeline, vector<OpenFileInfo> &files,
+                                           FileOpener *opener) {
+	auto context = FileOpener::TryGetClientContext(opener);
+	if (!context) {
+		return;
+	}
+	auto max_bytes = PathVariablePrefetcher::GetMaxMemory(*context);
+	if (max_bytes == 0) {
+		return;
+	}
+	// scalarfs paths are in memory already, and an unresolved path is handed back as is
+	vector<idx_t> fetch_indexes;
+	vector<string> paths;
+	for (idx_t i = 0; i < files.size(); i++) {
+		if (!PathVariablePipeline::IsScalarfsPath(files[i].path)) {
+			fetch_indexes.push_back(i);
+			paths.push_back(files[i].path);
+		}
+	}
+	if (paths.empty()) {
+		return;
+	}
+	idx_t window = pipeline.prefetch_window > 0 ? pipeline.prefetch_window : PathVariablePrefetcher::DEFAULT_WINDOW;
+	idx_t max_in_flight = MinValue<idx_t>(window, MaxValue<idx_t>(GetIOParallelism(*context), 1));
+	PathVariablePrefetcher::Get(*context).AddPipeline(*context, io_pool, std::move(paths), window, max_in_flight,
+	                                                  prefetch_used_bytes, max_bytes);
+	for (auto index : fetch_indexes) {
+		auto &info = files[index];
+		info.path = PathVariablePrefetcher::GetPrefetchedPath(info.path);
+	}
+}
+
+vector<OpenFileInfo> PathVariableFileSystem::ExpandPath(const string &path, FileOpener *opener) {
 	// =============================================================================
 	// Multi-level glob implementation with modifier support:
 	//
@@ -215,9 +1177,17 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 	//   no-glob        - Disable glob expansion in paths
 	//   search         - Return only first existing match
 	//   no-missing     - Skip non-existent files
-	//   no-cache       - Disable caching of glob results
+	//   no-cache       - Bypass the glob result cache
 	//   no-scalarfs    - Don't modify scalarfs protocol paths with append/prepend
 	//   no-protocols   - Don't modify explicit protocol paths with append/prepend
+	//   order!value    - Order of the result (name, size, none)
+	//   race[!k]       - Handled by Glob/OpenFile; candidates come from here
+	//   cache          - Handled by Glob/OpenFile (remote files read from local copies)
+	//   filter!regex   - Keep paths matching regex
+	//   exclude!regex  - Drop paths matching regex
+	//   limit!N        - Keep the first N paths (in generation order)
+	//   where!pred     - Keep files whose record fields / hive keys match
+	//   since!value    - Keep files modified after a watermark
 	//   append!value   - Append value to each path
 	//   prepend!value  - Prepend value to each path
 	//
@@ -232,15 +1202,13 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 		return {};
 	}
 
-	// Parse the path to extract modifiers and variable name
-	auto parsed = PathVariableParser::Parse(path);
+	// Parse the path and compile its modifiers (memoized per path string)
+	auto compiled = compile_cache.Compile(path);
+	auto &parsed = compiled->parsed;
+	auto &pipeline = compiled->pipeline;
 
-	// Caching is disabled by default because variable values can change between queries.
-	// The no-cache modifier exists for documentation/future use but caching is currently
-	// not implemented due to cache invalidation complexity.
-	// TODO: Implement proper cache invalidation (e.g., based on variable value hash)
-	bool use_cache = false; // Caching disabled until proper invalidation is implemented
-	string pattern = parsed.variable_name;
+	bool use_cache = pipeline.use_cache;
+	const string &pattern = parsed.variable_name;
 
 	// Get client context for variable access
 	auto context = FileOpener::TryGetClientContext(opener);
@@ -254,41 +1222,82 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 
 	vector<string> resolved_paths;
 
+	// Fingerprint of every variable consulted (name and value), validating cache entries
+	hash_t fingerprint = 0;
+	auto consult = [&fingerprint](const string &var_name, const Value &var_value) {
+		fingerprint = CombineHash(fingerprint, CombineHash(Hash(var_name.c_str(), var_name.size()), var_value.Hash()));
+	};
+
+	// where! operands: literals, or variables (part of the fingerprint)
+	vector<Value> where_operands;
+	for (auto &predicate : pipeline.predicates) {
+		if (!predicate.value.is_variable) {
+			where_operands.emplace_back(predicate.value.value);
+			continue;
+		}
+		Value operand;
+		if (!config.GetUserVariable(predicate.value.value, operand)) {
+			throw IOException("Variable '%s' (referenced in modifier) not found", predicate.value.value);
+		}
+		consult(predicate.value.value, operand);
+		where_operands.push_back(std::move(operand));
+	}
+	bool has_predicates = !pipeline.predicates.empty();
+
 	// Helper lambda to extract paths from a Value (handles scalar and list types)
-	auto extract_paths_from_value = [](const Value &var_value, vector<string> &out_paths) -> bool {
+	// File sizes carried by path records (used by order!size)
+	unordered_map<string, idx_t> record_sizes;
+	bool collect_sizes = pipeline.order == PathVariableOrder::SIZE;
+
+	auto extract_paths_from_value = [&](const Value &var_value, vector<string> &out_paths) -> bool {
 		if (var_value.IsNull()) {
 			return false;
 		}
 
 		auto &type = var_value.type();
 
-		// Handle list types (VARCHAR[] or BLOB[])
+		// Handle list types (VARCHAR[], BLOB[] or a list of path records)
 		if (type.id() == LogicalTypeId::LIST) {
-			auto &child_type = ListType::GetChildType(type);
-			if (child_type.id() != LogicalTypeId::VARCHAR && child_type.id() != LogicalTypeId::BLOB) {
+			if (!IsPathType(ListType::GetChildType(type))) {
 				return false; // Wrong child type
 			}
 
 			auto &children = ListValue::GetChildren(var_value);
+			out_paths.reserve(out_paths.size() + children.size());
 			for (const auto &child : children) {
-				if (!child.IsNull()) {
-					out_paths.push_back(child.ToString());
+				// where! on record fields drops records before they become paths
+				if (has_predicates && !RecordMatches(pipeline.predicates, where_operands, child)) {
+					continue;
+				}
+				string child_path;
+				if (GetPathFromValue(child, child_path)) {
+					idx_t record_size;
+					if (collect_sizes && GetSizeFromValue(child, record_size)) {
+						record_sizes[child_path] = record_size;
+					}
+					out_paths.push_back(std::move(child_path));
 				}
 			}
 			return true;
 		}
 
 		// Handle scalar types
-		if (type.id() != LogicalTypeId::VARCHAR && type.id() != LogicalTypeId::BLOB) {
+		if (!IsPathType(type)) {
 			return false; // Wrong type
 		}
 
-		out_paths.push_back(var_value.ToString());
+		string scalar_path;
+		if (!GetPathFromValue(var_value, scalar_path)) {
+			return false;
+		}
+		if (!has_predicates || RecordMatches(pipeline.predicates, where_operands, var_value)) {
+			out_paths.push_back(std::move(scalar_path));
+		}
 		return true;
 	};
 
 	// Helper to resolve a PathVariableValue (literal or variable reference)
-	auto resolve_value = [&config](const PathVariableValue &pv_value) -> vector<string> {
+	auto resolve_value = [&config, &consult](const PathVariableValue &pv_value) -> vector<string> {
 		if (pv_value.IsEmpty()) {
 			return {};
 		}
@@ -301,6 +1310,7 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 		if (!config.GetUserVariable(pv_value.value, var_result)) {
 			throw IOException("Variable '%s' (referenced in modifier) not found", pv_value.value);
 		}
+		consult(pv_value.value, var_result);
 		if (var_result.IsNull()) {
 			throw IOException("Variable '%s' (referenced in modifier) is NULL", pv_value.value);
 		}
@@ -325,53 +1335,9 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 		return values;
 	};
 
-	// Helper to join two path components with proper delimiter handling
-	auto join_paths = [](const string &base, const string &suffix) -> string {
-		if (base.empty()) {
-			return suffix;
-		}
-		if (suffix.empty()) {
-			return base;
-		}
-		// Handle trailing slash on base and leading slash on suffix
-		bool base_has_slash = (base.back() == '/' || base.back() == '\\');
-		bool suffix_has_slash = (suffix.front() == '/' || suffix.front() == '\\');
-		if (base_has_slash && suffix_has_slash) {
-			return base + suffix.substr(1);
-		}
-		if (!base_has_slash && !suffix_has_slash) {
-			return base + "/" + suffix;
-		}
-		return base + suffix;
-	};
-
-	// Helper to check if a path is a scalarfs protocol (should be passed through without modification)
-	auto is_scalarfs_path = [](const string &p) -> bool {
-		return StringUtil::StartsWith(p, "data:") || StringUtil::StartsWith(p, "data+varchar:") ||
-		       StringUtil::StartsWith(p, "data+blob:") || StringUtil::StartsWith(p, "variable:") ||
-		       StringUtil::StartsWith(p, "pathvariable:");
-	};
-
-	// Helper to check if a path has an explicit protocol (e.g., s3://, https://, file://)
-	auto has_explicit_protocol = [](const string &p) -> bool {
-		auto pos = p.find("://");
-		// Must have :// and some protocol name before it
-		return pos != string::npos && pos > 0 && pos < 20; // reasonable protocol name length
-	};
-
-	// Check which passthrough modes are enabled
-	bool passthru_scalarfs = parsed.HasModifier(PathVariableModifierFlag::PASSTHRU_SCALARFS);
-	bool passthru_explicit = parsed.HasModifier(PathVariableModifierFlag::PASSTHRU_EXPLICIT_FS);
-
-	// Helper to check if a path should be passed through (not modified by append/prepend)
-	auto should_passthru = [&](const string &p) -> bool {
-		if (passthru_scalarfs && is_scalarfs_path(p)) {
-			return true;
-		}
-		if (passthru_explicit && has_explicit_protocol(p)) {
-			return true;
-		}
-		return false;
+	// Helper to check if listing a path goes to a remote filesystem (cached with a TTL)
+	auto is_remote_path = [](const string &p) -> bool {
+		return PathVariablePipeline::HasExplicitProtocol(p) && !StringUtil::StartsWith(p, "file://");
 	};
 
 	// Check if the pattern contains glob characters
@@ -387,132 +1353,398 @@ vector<OpenFileInfo> PathVariableFileSystem::Glob(const string &path, FileOpener
 		if (!extract_paths_from_value(result, resolved_paths)) {
 			return {OpenFileInfo(path)};
 		}
+		consult(pattern, result);
 	} else {
-		// Level 1: Glob on variable names
-		for (const auto &entry : config.user_variables) {
-			const string &var_name = entry.first;
-			const Value &var_value = entry.second;
-
-			if (duckdb::Glob(var_name.c_str(), var_name.size(), pattern.c_str(), pattern.size())) {
+		// Level 1: Glob on variable names, resolved through the sorted name index
+		for (const auto &var_name : VariableNameIndex::Get(*context).Match(*context, pattern)) {
+			Value var_value;
+			if (config.GetUserVariable(var_name, var_value)) {
 				extract_paths_from_value(var_value, resolved_paths);
+				consult(var_name, var_value);
 			}
 		}
 	}
 
-	// Apply prepend modifier (before glob expansion)
-	if (parsed.HasModifier(PathVariableModifierFlag::PREPEND)) {
-		auto prepend_values = resolve_value(parsed.prepend_value);
-		if (!prepend_values.empty()) {
-			vector<string> new_paths;
-			// Cartesian product: prepend_values × resolved_paths
-			// But passthrough paths are kept unmodified
-			for (const auto &prefix : prepend_values) {
-				for (const auto &p : resolved_paths) {
-					if (should_passthru(p)) {
-						new_paths.push_back(p);
-					} else {
-						new_paths.push_back(join_paths(prefix, p));
-					}
-				}
+	// Resolve modifier values up front - variables they reference are part of the fingerprint
+	vector<string> prepend_values;
+	vector<string> append_values;
+	if (pipeline.has_prepend) {
+		prepend_values = resolve_value(parsed.prepend_value);
+	}
+	if (pipeline.has_append) {
+		append_values = resolve_value(parsed.append_value);
+	}
+
+	// since!watermark: a TIMESTAMP (or DATE, or string) variable or literal. A NULL
+	// variable means there is no watermark yet - every file is newer.
+	bool has_watermark = false;
+	timestamp_t watermark(0);
+	if (pipeline.since) {
+		Value since_value(parsed.since_value.value);
+		if (parsed.since_value.is_variable) {
+			if (!config.GetUserVariable(parsed.since_value.value, since_value)) {
+				throw IOException("Variable '%s' (referenced in modifier) not found", parsed.since_value.value);
 			}
-			resolved_paths = std::move(new_paths);
+			consult(parsed.since_value.value, since_value);
 		}
+		has_watermark = PathVariableWatermarks::GetTimestampFromValue(since_value, watermark);
 	}
 
-	// Apply append modifier (before glob expansion)
-	if (parsed.HasModifier(PathVariableModifierFlag::APPEND)) {
-		auto append_values = resolve_value(parsed.append_value);
-		if (!append_values.empty()) {
-			vector<string> new_paths;
-			// Cartesian product: resolved_paths × append_values
-			// But passthrough paths are kept unmodified
-			for (const auto &p : resolved_paths) {
-				if (should_passthru(p)) {
-					new_paths.push_back(p);
-				} else {
-					for (const auto &suffix : append_values) {
-						new_paths.push_back(join_paths(p, suffix));
-					}
-				}
+	// Record the newest file returned (or the watermark itself) for pathvariable_max_mtime()
+	auto record_watermark = [&](const vector<OpenFileInfo> &files) {
+		if (!pipeline.since) {
+			return;
+		}
+		bool has_max = has_watermark;
+		timestamp_t max_last_modified = watermark;
+		for (auto &info : files) {
+			timestamp_t last_modified;
+			if (PathVariableWatermarks::GetListedLastModified(info, last_modified) &&
+			    (!has_max || last_modified > max_last_modified)) {
+				max_last_modified = last_modified;
+				has_max = true;
 			}
-			resolved_paths = std::move(new_paths);
+		}
+		if (has_max) {
+			PathVariableWatermarks::Get(*context).Record(path, max_last_modified);
+		}
+	};
+
+	auto &cache = *glob_cache;
+	if (use_cache) {
+		vector<OpenFileInfo> cached;
+		if (cache.Lookup(path, fingerprint, cached)) {
+			record_watermark(cached);
+			return cached;
 		}
 	}
 
+	// Apply prepend, then append (before glob expansion)
+	pipeline.Apply(resolved_paths, prepend_values, append_values);
+
 	// Level 2: Expand globs within paths (unless no-glob modifier is set)
 	vector<OpenFileInfo> result;
-	bool no_glob = parsed.HasModifier(PathVariableModifierFlag::NO_GLOB);
+	bool check_existence = pipeline.existence_filter != PathVariableExistenceFilter::NONE;
+
+	// Track whether the result depends on the filesystem, and whether any of it is local
+	bool uses_filesystem = false;
+	bool uses_local_filesystem = false;
+
+	vector<idx_t> glob_indexes;
+	for (idx_t i = 0; i < resolved_paths.size(); i++) {
+		auto &resolved_path = resolved_paths[i];
+		bool expand = pipeline.expand_globs && FileSystem::HasGlob(resolved_path);
+		if (expand || check_existence) {
+			uses_filesystem = true;
+			if (!is_remote_path(resolved_path)) {
+				uses_local_filesystem = true;
+			}
+		}
+		if (expand) {
+			glob_indexes.push_back(i);
+		}
+	}
 
-	for (const string &resolved_path : resolved_paths) {
-		if (!no_glob && FileSystem::HasGlob(resolved_path)) {
-			auto expanded = parent_fs.Glob(resolved_path, nullptr);
-			for (auto &info : expanded) {
-				result.push_back(std::move(info));
+	// List globs concurrently, then merge in resolved path order. Without
+	// limit! everything is listed at once; with it, globs are listed one
+	// batch at a time and listing stops once enough paths are accepted.
+	// With since!, the limit applies to the newer files instead (below).
+	auto io_parallelism = MaxValue<idx_t>(GetIOParallelism(*context), 1);
+	idx_t generation_limit = pipeline.since ? 0 : pipeline.limit;
+	vector<vector<OpenFileInfo>> expanded(resolved_paths.size());
+	idx_t listed_globs = 0;
+	auto list_globs_through = [&](idx_t glob) {
+		if (glob < listed_globs) {
+			return;
+		}
+		idx_t end = glob_indexes.size();
+		if (generation_limit > 0) {
+			end = MinValue<idx_t>(end, glob + io_parallelism);
+		}
+		idx_t first = listed_globs;
+		RunConcurrently(end - first, io_parallelism, [&](idx_t task) {
+			auto index = glob_indexes[first + task];
+			expanded[index] = parent_fs.Glob(resolved_paths[index], nullptr);
+		});
+		listed_globs = end;
+	};
+
+	// filter!/exclude!/where!/limit! prune paths as they are generated, before
+	// the existence checks and the sort
+	bool prune = !pipeline.filters.empty() || !pipeline.excludes.empty() || has_predicates;
+	auto accepts = [&](const string &generated_path) {
+		return pipeline.Accepts(generated_path) &&
+		       (!has_predicates || HiveKeysMatch(pipeline.predicates, where_operands, generated_path));
+	};
+	auto limit_reached = [&]() {
+		return generation_limit > 0 && result.size() >= generation_limit;
+	};
+
+	// Paths are moved into the result, so only one copy of a large expansion is alive
+	if (generation_limit == 0) {
+		list_globs_through(0);
+		idx_t total_paths = resolved_paths.size() - glob_indexes.size();
+		for (auto index : glob_indexes) {
+			total_paths += expanded[index].size();
+		}
+		result.reserve(total_paths);
+	}
+	idx_t next_glob = 0;
+	for (idx_t i = 0; i < resolved_paths.size() && !limit_reached(); i++) {
+		if (next_glob < glob_indexes.size() && glob_indexes[next_glob] == i) {
+			list_globs_through(next_glob);
+			for (auto &info : expanded[i]) {
+				if (limit_reached()) {
+					break;
+				}
+				if (!prune || accepts(info.path)) {
+					result.push_back(std::move(info));
+				}
 			}
-		} else {
-			result.push_back(OpenFileInfo(resolved_path));
+			expanded[i].clear();
+			next_glob++;
+		} else if (!prune || accepts(resolved_paths[i])) {
+			result.push_back(OpenFileInfo(std::move(resolved_paths[i])));
 		}
 	}
 
-	// Apply search modifier FIRST (before sorting) - returns first existing in original order
-	// This is important for multi-root search where order matters (local before remote)
-	if (parsed.HasModifier(PathVariableModifierFlag::SEARCH)) {
-		for (auto &info : result) {
-			if (parent_fs.FileExists(info.path, nullptr)) {
-				return {std::move(info)};
+	// Keep files modified after the watermark. Remote listings (e.g. httpfs)
+	// carry the modification time already; only paths without one are looked
+	// up (one open each), concurrently. Their time is attached for the
+	// watermark record and kept for pathvariable_max_mtime().
+	if (pipeline.since) {
+		auto &watermarks = PathVariableWatermarks::Get(*context);
+		vector<timestamp_t> last_modified(result.size());
+		vector<uint8_t> found(result.size(), 1);
+		vector<idx_t> unknown;
+		for (idx_t i = 0; i < result.size(); i++) {
+			if (!PathVariableWatermarks::GetListedLastModified(result[i], last_modified[i])) {
+				unknown.push_back(i);
+				uses_filesystem = true;
+				if (!is_remote_path(result[i].path)) {
+					uses_local_filesystem = true;
+				}
 			}
 		}
-		// No existing files found - return empty (will cause "no files found" error)
-		return {};
+		RunConcurrently(unknown.size(), io_parallelism, [&](idx_t task) {
+			auto index = unknown[task];
+			auto flags = FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS;
+			auto handle = parent_fs.OpenFile(result[index].path, flags, nullptr);
+			if (!handle) {
+				found[index] = 0;
+				return;
+			}
+			last_modified[index] = parent_fs.GetLastModifiedTime(*handle);
+			PathVariableWatermarks::SetListedLastModified(result[index], last_modified[index]);
+			watermarks.RecordLastModified(result[index].path, last_modified[index]);
+		});
+		vector<OpenFileInfo> newer;
+		for (idx_t i = 0; i < result.size(); i++) {
+			if (pipeline.limit > 0 && newer.size() >= pipeline.limit) {
+				break;
+			}
+			// Missing files have no modification time - nothing new to load
+			if (found[i] && (!has_watermark || last_modified[i] > watermark)) {
+				newer.push_back(std::move(result[i]));
+			}
+		}
+		result = std::move(newer);
 	}
 
-	// Apply no-missing modifier (filter out non-existent files)
-	if (parsed.HasModifier(PathVariableModifierFlag::IGNORE_MISSING)) {
+	// Apply search modifier FIRST (before sorting) - returns first existing in original order
+	// This is important for multi-root search where order matters (local before remote)
+	// Candidates are probed concurrently, skipping recently missing ones (see ProbeFileExists)
+	auto missing_ttl = PathVariableMissingCache::GetTTLSeconds(*context);
+	if (pipeline.existence_filter == PathVariableExistenceFilter::FIRST_EXISTING) {
+		auto exists = ProbeFileExists(parent_fs, result, GetIOParallelism(*context), true, missing_ttl);
+		vector<OpenFileInfo> found;
+		for (idx_t i = 0; i < result.size(); i++) {
+			if (exists[i]) {
+				found.push_back(std::move(result[i]));
+				break;
+			}
+		}
+		// No existing files found - empty result (will cause "no files found" error)
+		result = std::move(found);
+	} else if (pipeline.existence_filter == PathVariableExistenceFilter::ALL_EXISTING) {
+		// Apply no-missing modifier (filter out non-existent files)
+		auto exists = ProbeFileExists(parent_fs, result, GetIOParallelism(*context), false, missing_ttl);
 		vector<OpenFileInfo> existing;
-		for (auto &info : result) {
-			if (parent_fs.FileExists(info.path, nullptr)) {
-				existing.push_back(std::move(info));
+		for (idx_t i = 0; i < result.size(); i++) {
+			if (exists[i]) {
+				existing.push_back(std::move(result[i]));
 			}
 		}
 		result = std::move(existing);
 	}
 
-	// Sort for deterministic ordering
-	std::sort(result.begin(), result.end(),
-	          [](const OpenFileInfo &a, const OpenFileInfo &b) { return a.path < b.path; });
+	// Order the result. The default sorts by path for deterministic output; level 1
+	// names, sorted list variables and single listings often arrive in order
+	// already - skip the O(n log n) sort then.
+	auto path_less = [](const OpenFileInfo &a, const OpenFileInfo &b) {
+		return a.path < b.path;
+	};
+	switch (pipeline.order) {
+	case PathVariableOrder::NAME:
+		if (!std::is_sorted(result.begin(), result.end(), path_less)) {
+			std::sort(result.begin(), result.end(), path_less);
+		}
+		break;
+	case PathVariableOrder::SIZE: {
+		// Largest first, so the biggest files are scheduled early instead of
+		// leaving threads idle at the end of a scan. Sizes come from path records
+		// or listing metadata; the rest are looked up concurrently.
+		vector<idx_t> sizes(result.size(), 0);
+		vector<idx_t> unknown;
+		for (idx_t i = 0; i < result.size(); i++) {
+			auto record = record_sizes.find(result[i].path);
+			if (record != record_sizes.end()) {
+				sizes[i] = record->second;
+			} else if (!GetListedFileSize(result[i], sizes[i])) {
+				unknown.push_back(i);
+				uses_filesystem = true;
+				if (!is_remote_path(result[i].path)) {
+					uses_local_filesystem = true;
+				}
+			}
+		}
+		RunConcurrently(unknown.size(), GetIOParallelism(*context), [&](idx_t task) {
+			auto index = unknown[task];
+			auto flags = FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS;
+			auto handle = parent_fs.OpenFile(result[index].path, flags, nullptr);
+			// Missing files sort last; reading them reports the error as usual
+			sizes[index] = handle ? handle->GetFileSize() : 0;
+		});
+
+		vector<idx_t> order(result.size());
+		for (idx_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) {
+			if (sizes[a] != sizes[b]) {
+				return sizes[a] > sizes[b];
+			}
+			return result[a].path < result[b].path;
+		});
+		vector<OpenFileInfo> ordered;
+		ordered.reserve(result.size());
+		for (auto index : order) {
+			ordered.push_back(std::move(result[index]));
+		}
+		result = std::move(ordered);
+		break;
+	}
+	case PathVariableOrder::NONE:
+		// Source order: level 1 names, list order, listing order
+		break;
+	}
 
-	// Store in cache (unless no-cache modifier is set)
-	if (use_cache) {
-		std::lock_guard<std::mutex> lock(cache_mutex);
-		glob_cache[path] = result;
+	record_watermark(result);
+
+	// Store in cache (unless no-cache modifier is set). Local listings are not
+	// cached, remote ones expire after the TTL.
+	if (use_cache && !uses_local_filesystem) {
+		uint64_t ttl = uses_filesystem ? PathVariableGlobCache::GetTTLSeconds(*context) : 0;
+		cache.Store(path, fingerprint, result, uses_filesystem, ttl);
 	}
 
 	return result;
 }
 
-void PathVariableFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	pv_handle.GetUnderlyingFileSystem().Read(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes, location);
+uint64_t PathVariableFileSystem::GetIOParallelism(ClientContext &context) {
+	Value parallelism;
+	if (context.TryGetCurrentSetting(IO_PARALLELISM_SETTING, parallelism) && !parallelism.IsNull()) {
+		return parallelism.GetValue<uint64_t>();
+	}
+	return DEFAULT_IO_PARALLELISM;
 }
 
-int64_t PathVariableFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().Read(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes);
+uint64_t PathVariableFileSystem::GetCaptureMaxSize(ClientContext &context) {
+	Value max_size;
+	if (context.TryGetCurrentSetting(CAPTURE_MAX_SIZE_SETTING, max_size) && !max_size.IsNull()) {
+		return max_size.GetValue<uint64_t>();
+	}
+	return DEFAULT_CAPTURE_MAX_SIZE;
 }
 
-void PathVariableFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	pv_handle.GetUnderlyingFileSystem().Write(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes, location);
+void PathVariableFileSystem::RunConcurrently(idx_t count, idx_t max_in_flight, const std::function<void(idx_t)> &task) {
+	io_pool->Run(count, max_in_flight, [&](idx_t i) {
+		task(i);
+		return true;
+	});
 }
 
-int64_t PathVariableFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().Write(pv_handle.GetUnderlyingHandle(), buffer, nr_bytes);
-}
+vector<bool> PathVariableFileSystem::ProbeFileExists(FileSystem &fs, const vector<OpenFileInfo> &candidates,
+                                                     idx_t max_in_flight, bool first_only, uint64_t missing_ttl) {
+	// =============================================================================
+	// Concurrent FileExists probes
+	// =============================================================================
+	//
+	// The candidates are probed in order on the calling thread and up to
+	// max_in_flight - 1 IO pool threads (see PathVariableIOPool::Run). Results
+	// are resolved strictly in candidate order, so with first_only no further
+	// candidates are dispatched once one exists and all earlier ones are known
+	// to be missing (probes already in flight are waited for).
+	//
+	// Errors are rethrown for the first failing candidate in order, matching
+	// what the sequential loop would have thrown.
+
+	enum class ProbeState : uint8_t { PENDING, EXISTS, MISSING, FAILED };
+
+	idx_t count = candidates.size();
+	vector<bool> exists(count, false);
+
+	std::mutex lock;
+	vector<ProbeState> states(count, ProbeState::PENDING);
+	vector<std::exception_ptr> errors(count);
+	// Candidates before this one are resolved and missing
+	idx_t resolved = 0;
+
+	// Known-missing candidates resolve without a request
+	auto &missing = *missing_cache;
+	io_pool->Run(count, max_in_flight, [&](idx_t i) {
+		ProbeState state;
+		std::exception_ptr error;
+		try {
+			auto &path = candidates[i].path;
+			bool cacheable = PathVariableMissingCache::IsCacheablePath(path);
+			if (cacheable && missing.IsKnownMissing(path)) {
+				state = ProbeState::MISSING;
+			} else if (fs.FileExists(path, nullptr)) {
+				state = ProbeState::EXISTS;
+			} else {
+				if (cacheable) {
+					missing.RecordMissing(path, missing_ttl);
+				}
+				state = ProbeState::MISSING;
+			}
+		} catch (...) {
+			state = ProbeState::FAILED;
+			error = std::current_exception();
+		}
 
-int64_t PathVariableFileSystem::GetFileSize(FileHandle &handle) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().GetFileSize(pv_handle.GetUnderlyingHandle());
+		std::lock_guard<std::mutex> guard(lock);
+		states[i] = state;
+		errors[i] = std::move(error);
+		while (resolved < count && states[resolved] != ProbeState::PENDING) {
+			if (states[resolved] == ProbeState::FAILED || (first_only && states[resolved] == ProbeState::EXISTS)) {
+				return false;
+			}
+			resolved++;
+		}
+		return true;
+	});
+
+	for (idx_t i = 0; i < count; i++) {
+		if (states[i] == ProbeState::FAILED) {
+			std::rethrow_exception(errors[i]);
+		}
+		exists[i] = states[i] == ProbeState::EXISTS;
+		if (first_only && exists[i]) {
+			break;
+		}
+	}
+	return exists;
 }
 
 bool PathVariableFileSystem::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
@@ -521,44 +1753,71 @@ bool PathVariableFileSystem::FileExists(const string &filename, optional_ptr<Fil
 	}
 
 	try {
-		string resolved_path = ResolvePath(filename, opener);
 		auto &parent_fs = GetParentFileSystem(opener);
+		string target_path;
+		if (PathVariablePrefetcher::ParsePrefetchedPath(filename, target_path) ||
+		    PathVariableDiskCache::ParseCachedPath(filename, target_path)) {
+			return parent_fs.FileExists(target_path, nullptr);
+		}
+		if (IsShardPath(filename)) {
+			string relative;
+			auto targets = GetShardTargets(filename, opener, relative);
+			for (auto &target : targets) {
+				auto target_path = PathVariablePipeline::JoinPaths(target, relative);
+				if (!relative.empty() && parent_fs.FileExists(target_path, nullptr)) {
+					return true;
+				}
+			}
+			return false;
+		}
+		string resolved_path = ResolvePath(filename, opener);
 		return parent_fs.FileExists(resolved_path, nullptr);
 	} catch (...) {
 		return false;
 	}
 }
 
-void PathVariableFileSystem::Seek(FileHandle &handle, idx_t location) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	pv_handle.GetUnderlyingFileSystem().Seek(pv_handle.GetUnderlyingHandle(), location);
-}
-
-idx_t PathVariableFileSystem::SeekPosition(FileHandle &handle) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().SeekPosition(pv_handle.GetUnderlyingHandle());
-}
-
-void PathVariableFileSystem::Reset(FileHandle &handle) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	pv_handle.GetUnderlyingFileSystem().Reset(pv_handle.GetUnderlyingHandle());
-}
-
-bool PathVariableFileSystem::CanSeek() {
-	return true;
-}
-
-bool PathVariableFileSystem::OnDiskFile(FileHandle &handle) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().OnDiskFile(pv_handle.GetUnderlyingHandle());
-}
-
-timestamp_t PathVariableFileSystem::GetLastModifiedTime(FileHandle &handle) {
-	auto &pv_handle = handle.Cast<PathVariableFileHandle>();
-	return pv_handle.GetUnderlyingFileSystem().GetLastModifiedTime(pv_handle.GetUnderlyingHandle());
+bool PathVariableFileSystem::IsPipe(const string &filename, optional_ptr<FileOpener> opener) {
+	if (!CanHandleFile(filename)) {
+		return false;
+	}
+	try {
+		auto &parent_fs = GetParentFileSystem(opener);
+		string target_path;
+		if (PathVariablePrefetcher::ParsePrefetchedPath(filename, target_path) ||
+		    PathVariableDiskCache::ParseCachedPath(filename, target_path)) {
+			return parent_fs.IsPipe(target_path, nullptr);
+		}
+		auto compiled = compile_cache.Compile(filename);
+		if (compiled->pipeline.shard || compiled->pipeline.race) {
+			return false;
+		}
+		return parent_fs.IsPipe(ResolvePath(filename, opener), nullptr);
+	} catch (...) {
+		// Unresolvable paths fail on open with a proper error
+		return false;
+	}
 }
 
 void PathVariableFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	if (IsShardPath(filename)) {
+		// COPY ... (OVERWRITE) clears a shard directory file by file
+		auto &parent_fs = GetParentFileSystem(opener);
+		string relative;
+		auto targets = GetShardTargets(filename, opener, relative);
+		bool removed = false;
+		for (auto &target : targets) {
+			auto target_path = PathVariablePipeline::JoinPaths(target, relative);
+			if (!relative.empty() && parent_fs.FileExists(target_path, nullptr)) {
+				parent_fs.RemoveFile(target_path, nullptr);
+				removed = true;
+			}
+		}
+		if (!removed) {
+			throw IOException("Could not remove '%s': not found in any shard target", filename);
+		}
+		return;
+	}
 	string resolved_path = ResolvePath(filename, opener);
 	auto &parent_fs = GetParentFileSystem(opener);
 	parent_fs.RemoveFile(resolved_path, nullptr);
@@ -588,6 +1847,58 @@ void PathVariableFileSystem::MoveFile(const string &source, const string &target
 
 	auto &parent_fs = GetParentFileSystem(opener);
 	parent_fs.MoveFile(source_path, target_path, nullptr);
+	missing_cache->Invalidate(target_path);
+}
+
+bool PathVariableFileSystem::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
+	if (!IsShardPath(directory)) {
+		return FileSystem::DirectoryExists(directory, opener);
+	}
+	// A shard directory exists once it exists below every target
+	auto &parent_fs = GetParentFileSystem(opener);
+	string relative;
+	for (auto &target : GetShardTargets(directory, opener, relative)) {
+		if (!parent_fs.DirectoryExists(PathVariablePipeline::JoinPaths(target, relative), nullptr)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PathVariableFileSystem::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+	if (!IsShardPath(directory)) {
+		FileSystem::CreateDirectory(directory, opener);
+		return;
+	}
+	auto &parent_fs = GetParentFileSystem(opener);
+	string relative;
+	for (auto &target : GetShardTargets(directory, opener, relative)) {
+		auto target_path = PathVariablePipeline::JoinPaths(target, relative);
+		if (!parent_fs.DirectoryExists(target_path, nullptr)) {
+			parent_fs.CreateDirectory(target_path, nullptr);
+		}
+	}
+}
+
+bool PathVariableFileSystem::ListFiles(const string &directory,
+                                       const std::function<void(const string &, bool)> &callback, FileOpener *opener) {
+	if (!IsShardPath(directory)) {
+		return FileSystem::ListFiles(directory, callback, opener);
+	}
+	// The union of the entries below every target
+	auto &parent_fs = GetParentFileSystem(opener);
+	string relative;
+	std::unordered_set<string> seen;
+	bool found = false;
+	for (auto &target : GetShardTargets(directory, opener, relative)) {
+		auto target_path = PathVariablePipeline::JoinPaths(target, relative);
+		found |= parent_fs.ListFiles(target_path, [&](const string &name, bool is_directory) {
+			if (seen.insert(name).second) {
+				callback(name, is_directory);
+			}
+		});
+	}
+	return found;
 }
 
 } // namespace duckdb
@@ -0,0 +1,173 @@
+#include "pathvariable_glob_cache.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+bool PathVariableGlobCache::Lookup(const string &path, hash_t fingerprint, vector<OpenFileInfo> &result) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = entries.find(path);
+	if (entry == entries.end()) {
+		return false;
+	}
+	if (entry->second.fingerprint != fingerprint ||
+	    (entry->second.expires && steady_clock::now() >= entry->second.expires_at)) {
+		entries.erase(entry);
+		return false;
+	}
+	result = entry->second.result;
+	return true;
+}
+
+void PathVariableGlobCache::Store(const string &path, hash_t fingerprint, const vector<OpenFileInfo> &result,
+                                  bool expires, uint64_t ttl_seconds) {
+	if (expires && ttl_seconds == 0) {
+		return;
+	}
+	auto now = steady_clock::now();
+
+	std::lock_guard<std::mutex> guard(lock);
+	if (entries.size() >= MAX_ENTRIES && entries.find(path) == entries.end()) {
+		// Drop expired entries first; if that is not enough, start over
+		for (auto it = entries.begin(); it != entries.end();) {
+			if (it->second.expires && now >= it->second.expires_at) {
+				it = entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (entries.size() >= MAX_ENTRIES) {
+			entries.clear();
+		}
+	}
+	entries[path] = Entry {fingerprint, result, expires, now + std::chrono::seconds(ttl_seconds)};
+}
+
+idx_t PathVariableGlobCache::Clear() {
+	std::lock_guard<std::mutex> guard(lock);
+	idx_t count = entries.size();
+	entries.clear();
+	return count;
+}
+
+uint64_t PathVariableGlobCache::GetTTLSeconds(ClientContext &context) {
+	Value ttl;
+	if (context.TryGetCurrentSetting(TTL_SETTING, ttl) && !ttl.IsNull()) {
+		return ttl.GetValue<uint64_t>();
+	}
+	return DEFAULT_TTL_SECONDS;
+}
+
+// =============================================================================
+// PathVariableMissingCache
+// =============================================================================
+
+bool PathVariableMissingCache::IsKnownMissing(const string &path) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = entries.find(path);
+	if (entry == entries.end()) {
+		return false;
+	}
+	if (steady_clock::now() >= entry->second) {
+		entries.erase(entry);
+		return false;
+	}
+	return true;
+}
+
+void PathVariableMissingCache::RecordMissing(const string &path, uint64_t ttl_seconds) {
+	if (ttl_seconds == 0) {
+		return;
+	}
+	auto now = steady_clock::now();
+
+	std::lock_guard<std::mutex> guard(lock);
+	if (entries.size() >= MAX_ENTRIES && entries.find(path) == entries.end()) {
+		for (auto it = entries.begin(); it != entries.end();) {
+			if (now >= it->second) {
+				it = entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (entries.size() >= MAX_ENTRIES) {
+			entries.clear();
+		}
+	}
+	entries[path] = now + std::chrono::seconds(ttl_seconds);
+}
+
+void PathVariableMissingCache::Invalidate(const string &path) {
+	std::lock_guard<std::mutex> guard(lock);
+	entries.erase(path);
+}
+
+idx_t PathVariableMissingCache::Clear() {
+	std::lock_guard<std::mutex> guard(lock);
+	idx_t count = entries.size();
+	entries.clear();
+	return count;
+}
+
+bool PathVariableMissingCache::IsCacheablePath(const string &path) {
+	static const char *const VIRTUAL_PREFIXES[] = {"data:",         "data+",         "variable:",
+	                                               "tmp_variable:", "pathvariable:", "tmp_pathvariable:",
+	                                               "decompress+"};
+	for (auto prefix : VIRTUAL_PREFIXES) {
+		if (StringUtil::StartsWith(path, prefix)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t PathVariableMissingCache::GetTTLSeconds(ClientContext &context) {
+	Value ttl;
+	if (context.TryGetCurrentSetting(TTL_SETTING, ttl) && !ttl.IsNull()) {
+		return ttl.GetValue<uint64_t>();
+	}
+	return DEFAULT_TTL_SECONDS;
+}
+
+// =============================================================================
+// pathvariable_clear_cache()
+// =============================================================================
+
+struct PathVariableCacheInfo : public ScalarFunctionInfo {
+	PathVariableCacheInfo(shared_ptr<PathVariableGlobCache> glob_cache_p,
+	                      shared_ptr<PathVariableMissingCache> missing_cache_p)
+	    : glob_cache(std::move(glob_cache_p)), missing_cache(std::move(missing_cache_p)) {
+	}
+	shared_ptr<PathVariableGlobCache> glob_cache;
+	shared_ptr<PathVariableMissingCache> missing_cache;
+};
+
+static void ClearCacheFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.function.function_info->Cast<PathVariableCacheInfo>();
+
+	idx_t removed = info.glob_cache->Clear() + info.missing_cache->Clear();
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<int64_t>(result)[0] = NumericCast<int64_t>(removed);
+}
+
+void PathVariableGlobCache::Register(ExtensionLoader &loader, shared_ptr<PathVariableGlobCache> glob_cache,
+                                     shared_ptr<PathVariableMissingCache> missing_cache) {
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(TTL_SETTING,
+	                          "Seconds to cache pathvariable: glob results that list remote paths (0 disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_TTL_SECONDS));
+	config.AddExtensionOption(PathVariableMissingCache::TTL_SETTING,
+	                          "Seconds to remember files that pathvariable: search/no-missing found missing "
+	                          "(0 disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(PathVariableMissingCache::DEFAULT_TTL_SECONDS));
+
+	ScalarFunction clear_cache("pathvariable_clear_cache", {}, LogicalType::BIGINT, ClearCacheFunction);
+	clear_cache.stability = FunctionStability::VOLATILE;
+	clear_cache.function_info = make_shared_ptr<PathVariableCacheInfo>(std::move(glob_cache), std::move(missing_cache));
+	loader.RegisterFunction(clear_cache);
+}
+
+} // namespace duckdb
@@ -0,0 +1,176 @@
+#include "pathvariable_io_pool.hpp"
+
+namespace duckdb {
+
+struct PathVariableIOPool::Workers {
+	std::mutex lock;
+	std::condition_variable cv;
+	std::deque<std::function<void()>> jobs;
+	idx_t threads = 0;
+	// Threads waiting for a job
+	idx_t idle = 0;
+	// Threads started by StartDetached and still running
+	idx_t detached = 0;
+	bool stopping = false;
+};
+
+PathVariableIOPool::PathVariableIOPool() : workers(make_shared_ptr<Workers>()) {
+}
+
+PathVariableIOPool::~PathVariableIOPool() {
+	{
+		std::lock_guard<std::mutex> guard(workers->lock);
+		workers->stopping = true;
+		workers->jobs.clear();
+	}
+	workers->cv.notify_all();
+}
+
+void PathVariableIOPool::Submit(std::function<void()> job) {
+#ifndef DUCKDB_NO_THREADS
+	{
+		std::lock_guard<std::mutex> guard(workers->lock);
+		workers->jobs.push_back(std::move(job));
+		if (workers->idle == 0 && workers->threads < MAX_THREADS) {
+			std::thread(Work, workers).detach();
+			workers->threads++;
+		}
+	}
+	workers->cv.notify_one();
+#else
+	try {
+		job();
+	} catch (...) {
+	}
+#endif
+}
+
+bool PathVariableIOPool::StartDetached(std::function<void()> job) {
+#ifndef DUCKDB_NO_THREADS
+	{
+		std::lock_guard<std::mutex> guard(workers->lock);
+		if (workers->stopping || workers->detached >= MAX_DETACHED_THREADS) {
+			return false;
+		}
+		workers->detached++;
+	}
+	auto state = workers;
+	std::thread([state, job]() {
+		try {
+			job();
+		} catch (...) {
+			// Jobs report their errors through their own state
+		}
+		std::lock_guard<std::mutex> guard(state->lock);
+		state->detached--;
+	}).detach();
+	return true;
+#else
+	return false;
+#endif
+}
+
+// The tasks of a Run() call. Helpers hold it by shared_ptr: one that only
+// starts after the call returned finds it done and leaves the task alone.
+struct PathVariableIOPool::RunState {
+	RunState(idx_t count_p, const std::function<bool(idx_t)> &task_p) : count(count_p), task(task_p) {
+	}
+
+	const idx_t count;
+	const std::function<bool(idx_t)> &task;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	vector<std::exception_ptr> errors;
+	idx_t next = 0;
+	// Helpers running tasks
+	idx_t active = 0;
+	// No new tasks start
+	bool done = false;
+};
+
+void PathVariableIOPool::RunTasks(RunState &state) {
+	std::unique_lock<std::mutex> guard(state.lock);
+	while (!state.done && state.next < state.count) {
+		idx_t index = state.next++;
+		guard.unlock();
+		bool more;
+		std::exception_ptr error;
+		try {
+			more = state.task(index);
+		} catch (...) {
+			more = false;
+			error = std::current_exception();
+		}
+		guard.lock();
+		if (error) {
+			state.errors[index] = std::move(error);
+		}
+		if (!more) {
+			state.done = true;
+		}
+	}
+}
+
+void PathVariableIOPool::Run(idx_t count, idx_t max_in_flight, const std::function<bool(idx_t)> &task) {
+	auto state = make_shared_ptr<RunState>(count, task);
+	state->errors.resize(count);
+#ifndef DUCKDB_NO_THREADS
+	idx_t helpers = MinValue<idx_t>(MaxValue<idx_t>(max_in_flight, 1), count) - (count > 0 ? 1 : 0);
+	for (idx_t h = 0; h < helpers; h++) {
+		Submit([state]() {
+			{
+				std::lock_guard<std::mutex> guard(state->lock);
+				if (state->done) {
+					return;
+				}
+				state->active++;
+			}
+			RunTasks(*state);
+			{
+				std::lock_guard<std::mutex> guard(state->lock);
+				state->active--;
+			}
+			state->cv.notify_all();
+		});
+	}
+#endif
+	RunTasks(*state);
+
+	// The tasks are all started: wait for the helpers still running one
+	std::unique_lock<std::mutex> guard(state->lock);
+	state->done = true;
+	state->cv.wait(guard, [&]() { return state->active == 0; });
+	// Rethrow the error of the first failing task, as a sequential loop would
+	for (auto &error : state->errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+void PathVariableIOPool::Work(shared_ptr<Workers> workers) {
+	std::unique_lock<std::mutex> guard(workers->lock);
+	while (true) {
+		workers->idle++;
+		workers->cv.wait(guard, [&]() { return workers->stopping || !workers->jobs.empty(); });
+		workers->idle--;
+		if (workers->stopping) {
+			workers->threads--;
+			return;
+		}
+		auto job = std::move(workers->jobs.front());
+		workers->jobs.pop_front();
+		guard.unlock();
+		try {
+			job();
+		} catch (...) {
+			// Jobs report their errors through their own state
+		}
+		// The job (and the state it captured) goes away outside the lock
+		job = nullptr;
+		guard.lock();
+	}
+}
+
+} // namespace duckdb
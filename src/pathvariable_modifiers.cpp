@@ -0,0 +1,507 @@
+#include "pathvariable_modifiers.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+PathVariablePipeline PathVariablePipeline::Compile(const ParsedPathVariablePath &parsed) {
+	PathVariablePipeline pipeline;
+	pipeline.has_prepend = parsed.HasModifier(PathVariableModifierFlag::PREPEND);
+	pipeline.has_append = parsed.HasModifier(PathVariableModifierFlag::APPEND);
+	pipeline.expand_globs = !parsed.HasModifier(PathVariableModifierFlag::NO_GLOB);
+	pipeline.disk_cache = parsed.HasModifier(PathVariableModifierFlag::CACHE);
+	pipeline.shard = parsed.HasModifier(PathVariableModifierFlag::SHARD);
+	pipeline.shard_mode = parsed.shard_mode;
+	// Regexes are compiled once per path string (the compiled path is memoized)
+	auto compile_regex = [](const string &modifier, const string &pattern) {
+		auto regex = make_shared_ptr<duckdb_re2::RE2>(pattern, duckdb_re2::RE2::Quiet);
+		if (!regex->ok()) {
+			throw InvalidInputException("Invalid pathvariable: %s regex '%s': %s", modifier, pattern, regex->error());
+		}
+		return shared_ptr<const duckdb_re2::RE2>(std::move(regex));
+	};
+	for (auto &pattern : parsed.filter_patterns) {
+		pipeline.filters.push_back(compile_regex("filter", pattern));
+	}
+	for (auto &pattern : parsed.exclude_patterns) {
+		pipeline.excludes.push_back(compile_regex("exclude", pattern));
+	}
+	pipeline.limit = parsed.limit;
+	pipeline.predicates = parsed.where_predicates;
+	pipeline.since = parsed.HasModifier(PathVariableModifierFlag::SINCE);
+	pipeline.use_cache = !parsed.HasModifier(PathVariableModifierFlag::NO_CACHE);
+	pipeline.passthru_scalarfs = parsed.HasModifier(PathVariableModifierFlag::PASSTHRU_SCALARFS);
+	pipeline.passthru_explicit = parsed.HasModifier(PathVariableModifierFlag::PASSTHRU_EXPLICIT_FS);
+	if (parsed.HasModifier(PathVariableModifierFlag::SEARCH)) {
+		pipeline.existence_filter = PathVariableExistenceFilter::FIRST_EXISTING;
+	} else if (parsed.HasModifier(PathVariableModifierFlag::IGNORE_MISSING)) {
+		pipeline.existence_filter = PathVariableExistenceFilter::ALL_EXISTING;
+	}
+	pipeline.order = parsed.order;
+	pipeline.race = parsed.HasModifier(PathVariableModifierFlag::RACE);
+	pipeline.race_count = parsed.race_count;
+	if (pipeline.race && !parsed.HasModifier(PathVariableModifierFlag::ORDER)) {
+		// Mirrors are listed in order of preference - race!k takes the first k
+		pipeline.order = PathVariableOrder::NONE;
+	}
+	// A race already hedges the open, and a capture reads one file - there is nothing to read ahead
+	pipeline.prefetch = parsed.HasModifier(PathVariableModifierFlag::PREFETCH) && !pipeline.race &&
+	                    !parsed.HasModifier(PathVariableModifierFlag::CAPTURE);
+	pipeline.prefetch_window = parsed.prefetch_window;
+	pipeline.capture = parsed.HasModifier(PathVariableModifierFlag::CAPTURE);
+	pipeline.capture_variable = parsed.capture_variable;
+	pipeline.capture_full = parsed.capture_full;
+	return pipeline;
+}
+
+bool PathVariablePipeline::IsScalarfsPath(const string &path) {
+	return StringUtil::StartsWith(path, "data:") || StringUtil::StartsWith(path, "data+varchar:") ||
+	       StringUtil::StartsWith(path, "data+blob:") || StringUtil::StartsWith(path, "variable:") ||
+	       StringUtil::StartsWith(path, "pathvariable:");
+}
+
+bool PathVariablePipeline::HasExplicitProtocol(const string &path) {
+	auto pos = path.find("://");
+	// Must have :// and some protocol name before it
+	return pos != string::npos && pos > 0 && pos < 20; // reasonable protocol name length
+}
+
+bool PathVariablePipeline::ShouldPassthru(const string &path) const {
+	if (passthru_scalarfs && IsScalarfsPath(path)) {
+		return true;
+	}
+	if (passthru_explicit && HasExplicitProtocol(path)) {
+		return true;
+	}
+	return false;
+}
+
+bool PathVariablePipeline::Accepts(const string &path) const {
+	for (auto &regex : filters) {
+		if (!duckdb_re2::RE2::PartialMatch(path, *regex)) {
+			return false;
+		}
+	}
+	for (auto &regex : excludes) {
+		if (duckdb_re2::RE2::PartialMatch(path, *regex)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PathVariablePredicate::Matches(const Value &field_value, const Value &operand) const {
+	if (field_value.IsNull() || operand.IsNull()) {
+		return false;
+	}
+	switch (comparison) {
+	case PathVariableComparison::EQUAL:
+		return field_value == operand;
+	case PathVariableComparison::NOT_EQUAL:
+		return field_value != operand;
+	case PathVariableComparison::LESS:
+		return field_value < operand;
+	case PathVariableComparison::LESS_EQUAL:
+		return field_value <= operand;
+	case PathVariableComparison::GREATER:
+		return field_value > operand;
+	case PathVariableComparison::GREATER_EQUAL:
+		return field_value >= operand;
+	}
+	return false;
+}
+
+string PathVariablePipeline::JoinPaths(const string &base, const string &suffix) {
+	if (base.empty()) {
+		return suffix;
+	}
+	if (suffix.empty()) {
+		return base;
+	}
+	// Handle trailing slash on base and leading slash on suffix
+	bool base_has_slash = (base.back() == '/' || base.back() == '\\');
+	bool suffix_has_slash = (suffix.front() == '/' || suffix.front() == '\\');
+	if (base_has_slash && suffix_has_slash) {
+		return base + suffix.substr(1);
+	}
+	if (!base_has_slash && !suffix_has_slash) {
+		return base + "/" + suffix;
+	}
+	return base + suffix;
+}
+
+void PathVariablePipeline::Apply(vector<string> &paths, const vector<string> &prefixes,
+                                        const vector<string> &suffixes) const {
+	bool prepend = has_prepend && !prefixes.empty();
+	bool append = has_append && !suffixes.empty();
+	if (!prepend && !append) {
+		return;
+	}
+
+	// Cartesian product: prefixes x paths x suffixes. Passthrough paths are kept
+	// unmodified by each step, and a prepended path is checked again before
+	// appending, exactly as if the two steps ran one after the other.
+	idx_t prefix_count = prepend ? prefixes.size() : 1;
+	vector<string> new_paths;
+	new_paths.reserve(paths.size() * prefix_count * (append ? suffixes.size() : 1));
+	for (idx_t i = 0; i < prefix_count; i++) {
+		for (const auto &p : paths) {
+			string prepended = (!prepend || ShouldPassthru(p)) ? p : JoinPaths(prefixes[i], p);
+			if (!append || ShouldPassthru(prepended)) {
+				new_paths.push_back(std::move(prepended));
+				continue;
+			}
+			for (const auto &suffix : suffixes) {
+				new_paths.push_back(JoinPaths(prepended, suffix));
+			}
+		}
+	}
+	paths = std::move(new_paths);
+}
+
+bool PathVariableParser::CanHandle(const string &path) {
+	return StringUtil::StartsWith(path, "pathvariable:") || StringUtil::StartsWith(path, "tmp_pathvariable:");
+}
+
+bool PathVariableParser::IsTempPath(const string &path) {
+	return StringUtil::StartsWith(path, "tmp_pathvariable:");
+}
+
+PathVariableValue PathVariableParser::ParseValue(const string &value_str) {
+	if (value_str.empty()) {
+		return PathVariableValue();
+	}
+	if (value_str[0] == '$') {
+		// Variable reference - strip the $
+		return PathVariableValue(value_str.substr(1), true);
+	}
+	// Literal value
+	return PathVariableValue(value_str, false);
+}
+
+idx_t PathVariableParser::ParseCount(const string &mod_name, const string &mod_value, const string &expected) {
+	idx_t count = 0;
+	for (auto c : mod_value) {
+		if (c < '0' || c > '9' || count > 1000000000) {
+			count = 0;
+			break;
+		}
+		count = count * 10 + NumericCast<idx_t>(c - '0');
+	}
+	if (count == 0) {
+		throw InvalidInputException("Invalid pathvariable: %s count '%s' (expected %s)", mod_name, mod_value, expected);
+	}
+	return count;
+}
+
+PathVariablePredicate PathVariableParser::ParsePredicate(const string &mod_value) {
+	static const pair<const char *, PathVariableComparison> operators[] = {
+	    {"<=", PathVariableComparison::LESS_EQUAL}, {">=", PathVariableComparison::GREATER_EQUAL},
+	    {"!=", PathVariableComparison::NOT_EQUAL},  {"<>", PathVariableComparison::NOT_EQUAL},
+	    {"=", PathVariableComparison::EQUAL},       {"<", PathVariableComparison::LESS},
+	    {">", PathVariableComparison::GREATER}};
+
+	PathVariablePredicate predicate;
+	auto op_pos = mod_value.find_first_of("=!<>");
+	if (op_pos != string::npos && op_pos > 0) {
+		predicate.field = mod_value.substr(0, op_pos);
+		for (auto &op : operators) {
+			auto op_size = strlen(op.first);
+			if (mod_value.compare(op_pos, op_size, op.first) == 0 && op_pos + op_size < mod_value.size()) {
+				predicate.comparison = op.second;
+				predicate.value = ParseValue(mod_value.substr(op_pos + op_size));
+				return predicate;
+			}
+		}
+	}
+	throw InvalidInputException("Invalid pathvariable: where predicate '%s' (expected where!<field><op><value> with "
+	                            "op =, !=, <, <=, > or >=)",
+	                            mod_value);
+}
+
+bool PathVariableParser::ParseModifier(const string &modifier, ParsedPathVariablePath &result) {
+	// Check for modifiers with values (contain !)
+	auto bang_pos = modifier.find('!');
+	string mod_name = (bang_pos != string::npos) ? modifier.substr(0, bang_pos) : modifier;
+	string mod_value = (bang_pos != string::npos) ? modifier.substr(bang_pos + 1) : "";
+
+	if (mod_name == "no-glob") {
+		result.flags |= PathVariableModifierFlag::NO_GLOB;
+		return true;
+	}
+	if (mod_name == "search") {
+		result.flags |= PathVariableModifierFlag::SEARCH;
+		return true;
+	}
+	if (mod_name == "no-missing") {
+		result.flags |= PathVariableModifierFlag::IGNORE_MISSING;
+		return true;
+	}
+	if (mod_name == "no-scalarfs") {
+		result.flags |= PathVariableModifierFlag::PASSTHRU_SCALARFS;
+		return true;
+	}
+	if (mod_name == "no-protocols") {
+		result.flags |= PathVariableModifierFlag::PASSTHRU_EXPLICIT_FS;
+		return true;
+	}
+	if (mod_name == "no-cache") {
+		result.flags |= PathVariableModifierFlag::NO_CACHE;
+		return true;
+	}
+	if (mod_name == "order") {
+		result.flags |= PathVariableModifierFlag::ORDER;
+		auto order = StringUtil::Lower(mod_value);
+		if (order == "name") {
+			result.order = PathVariableOrder::NAME;
+		} else if (order == "size") {
+			result.order = PathVariableOrder::SIZE;
+		} else if (order == "none") {
+			result.order = PathVariableOrder::NONE;
+		} else {
+			throw InvalidInputException("Unknown pathvariable: order '%s' (expected order!name, order!size or "
+			                            "order!none)",
+			                            mod_value);
+		}
+		return true;
+	}
+	if (mod_name == "shard") {
+		result.flags |= PathVariableModifierFlag::SHARD;
+		auto mode = StringUtil::Lower(mod_value);
+		if (mode.empty() || mode == "round-robin") {
+			result.shard_mode = PathVariableShardMode::ROUND_ROBIN;
+		} else if (mode == "least-bytes") {
+			result.shard_mode = PathVariableShardMode::LEAST_BYTES;
+		} else {
+			throw InvalidInputException("Unknown pathvariable: shard mode '%s' (expected shard, shard!round-robin or "
+			                            "shard!least-bytes)",
+			                            mod_value);
+		}
+		return true;
+	}
+	if (mod_name == "cache") {
+		result.flags |= PathVariableModifierFlag::CACHE;
+		return true;
+	}
+	if (mod_name == "race") {
+		result.flags |= PathVariableModifierFlag::RACE;
+		result.race_count = 0;
+		if (!mod_value.empty()) {
+			result.race_count = ParseCount(mod_name, mod_value, "race or race!k with k > 0");
+		}
+		return true;
+	}
+	if (mod_name == "prefetch") {
+		result.flags |= PathVariableModifierFlag::PREFETCH;
+		result.prefetch_window = 0;
+		if (!mod_value.empty()) {
+			result.prefetch_window = ParseCount(mod_name, mod_value, "prefetch or prefetch!k with k > 0");
+		}
+		return true;
+	}
+	if (mod_name == "capture") {
+		if (mod_value.empty()) {
+			throw InvalidInputException("Invalid pathvariable: capture needs a variable name (capture!<variable>)");
+		}
+		result.flags |= PathVariableModifierFlag::CAPTURE;
+		result.capture_variable = mod_value;
+		result.capture_full = false;
+		auto option_pos = mod_value.find('!');
+		if (option_pos != string::npos) {
+			auto option = mod_value.substr(option_pos + 1);
+			if (option != "full") {
+				throw InvalidInputException(
+				    "Invalid pathvariable: capture option '%s' (expected capture!<variable>!full)", option);
+			}
+			result.capture_variable = mod_value.substr(0, option_pos);
+			result.capture_full = true;
+		}
+		if (result.capture_variable.empty()) {
+			throw InvalidInputException("Invalid pathvariable: capture needs a variable name (capture!<variable>)");
+		}
+		return true;
+	}
+	if (mod_name == "filter" || mod_name == "exclude") {
+		// The regex is everything after the first '!' (it cannot contain ':')
+		if (mod_value.empty()) {
+			throw InvalidInputException("Invalid pathvariable: %s needs a regex (%s!<regex>)", mod_name, mod_name);
+		}
+		if (mod_name == "filter") {
+			result.flags |= PathVariableModifierFlag::FILTER;
+			result.filter_patterns.push_back(mod_value);
+		} else {
+			result.flags |= PathVariableModifierFlag::EXCLUDE;
+			result.exclude_patterns.push_back(mod_value);
+		}
+		return true;
+	}
+	if (mod_name == "limit") {
+		result.flags |= PathVariableModifierFlag::LIMIT;
+		result.limit = ParseCount(mod_name, mod_value, "limit!N with N > 0");
+		return true;
+	}
+	if (mod_name == "where") {
+		// The predicate is everything after the first '!' (where!a!=b compares with !=)
+		result.flags |= PathVariableModifierFlag::WHERE;
+		result.where_predicates.push_back(ParsePredicate(mod_value));
+		return true;
+	}
+	if (mod_name == "since") {
+		// The watermark is everything after the first '!' (it cannot contain ':' -
+		// use a $variable for timestamps with a time of day)
+		if (mod_value.empty()) {
+			throw InvalidInputException(
+			    "Invalid pathvariable: since needs a watermark (since!$variable or since!<date>)");
+		}
+		result.flags |= PathVariableModifierFlag::SINCE;
+		result.since_value = ParseValue(mod_value);
+		return true;
+	}
+	if (mod_name == "append") {
+		result.flags |= PathVariableModifierFlag::APPEND;
+		result.append_value = ParseValue(mod_value);
+		return true;
+	}
+	if (mod_name == "prepend") {
+		result.flags |= PathVariableModifierFlag::PREPEND;
+		result.prepend_value = ParseValue(mod_value);
+		return true;
+	}
+
+	// Not a recognized modifier
+	return false;
+}
+
+ParsedPathVariablePath PathVariableParser::Parse(const string &path) {
+	ParsedPathVariablePath result;
+
+	// Determine prefix and starting position
+	string remainder;
+	if (StringUtil::StartsWith(path, "tmp_pathvariable:")) {
+		result.is_temp = true;
+		remainder = path.substr(17); // len("tmp_pathvariable:")
+	} else if (StringUtil::StartsWith(path, "pathvariable:")) {
+		result.is_temp = false;
+		remainder = path.substr(13); // len("pathvariable:")
+	} else {
+		// Not a pathvariable path - return empty result
+		return result;
+	}
+
+	// Split by colons to find modifiers
+	// Format: [modifier:]...[modifier:]varname[!value]
+	// The last segment (or first segment without a following colon) is the variable name
+	//
+	// We need to be careful: the variable name could contain a ! for append/prepend
+	// that was specified at the end rather than with the modifier
+	//
+	// Examples:
+	//   pathvariable:varname              -> varname
+	//   pathvariable:no-glob:varname      -> no-glob modifier, varname
+	//   pathvariable:search:varname       -> search modifier, varname
+	//   pathvariable:append:varname!/path -> append modifier with value, varname
+	//   pathvariable:append!/path:varname -> append modifier with value, varname (alt syntax)
+
+	vector<string> segments;
+	size_t start = 0;
+	size_t pos = 0;
+
+	while ((pos = remainder.find(':', start)) != string::npos) {
+		segments.push_back(remainder.substr(start, pos - start));
+		start = pos + 1;
+	}
+	// Add the last segment
+	segments.push_back(remainder.substr(start));
+
+	if (segments.empty()) {
+		return result;
+	}
+
+	// Process segments from left to right
+	// Each segment is either a modifier or the variable name
+	// The variable name is the first segment that's NOT a recognized modifier
+	for (size_t i = 0; i < segments.size(); i++) {
+		const string &segment = segments[i];
+
+		// Try to parse as a modifier
+		if (ParseModifier(segment, result)) {
+			continue;
+		}
+
+		// Not a modifier - this is the variable name
+		// Everything from here to the end is part of the variable name (rejoin with :)
+		string var_part;
+		for (size_t j = i; j < segments.size(); j++) {
+			if (j > i) {
+				var_part += ":";
+			}
+			var_part += segments[j];
+		}
+
+		// Check for ! in the variable part (for append/prepend values specified at end)
+		// But only if we don't already have an append value
+		auto bang_pos = var_part.find('!');
+		if (bang_pos != string::npos && result.append_value.IsEmpty() && result.prepend_value.IsEmpty()) {
+			// This could be varname!value syntax
+			// Only treat as value if we have an append or prepend modifier without a value
+			if (HasFlag(result.flags, PathVariableModifierFlag::APPEND) ||
+			    HasFlag(result.flags, PathVariableModifierFlag::PREPEND)) {
+				result.variable_name = var_part.substr(0, bang_pos);
+				auto value = ParseValue(var_part.substr(bang_pos + 1));
+				if (HasFlag(result.flags, PathVariableModifierFlag::APPEND)) {
+					result.append_value = value;
+				} else {
+					result.prepend_value = value;
+				}
+			} else {
+				// No append/prepend modifier, so ! is part of the variable name
+				// (unlikely but possible)
+				result.variable_name = var_part;
+			}
+		} else {
+			result.variable_name = var_part;
+		}
+		break;
+	}
+
+	return result;
+}
+
+// =============================================================================
+// PathVariableCompileCache Implementation
+// =============================================================================
+
+shared_ptr<const CompiledPathVariablePath> PathVariableCompileCache::Compile(const string &path) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto entry = entries.find(path);
+		if (entry != entries.end()) {
+			// Most recently used first
+			recency.splice(recency.begin(), recency, entry->second.position);
+			return entry->second.compiled;
+		}
+	}
+
+	auto compiled = make_shared_ptr<CompiledPathVariablePath>();
+	compiled->parsed = PathVariableParser::Parse(path);
+	compiled->pipeline = PathVariablePipeline::Compile(compiled->parsed);
+
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = entries.find(path);
+	if (entry != entries.end()) {
+		// Compiled concurrently by another thread
+		return entry->second.compiled;
+	}
+	if (entries.size() >= MAX_ENTRIES) {
+		// Evict the least recently used path
+		entries.erase(recency.back());
+		recency.pop_back();
+	}
+	recency.push_front(path);
+	entries[path] = Entry {compiled, recency.begin()};
+	return compiled;
+}
+
+} // namespace duckdb
@@ -0,0 +1,336 @@
+#include "pathvariable_prefetch.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+static constexpr const char *PREFETCHED_PREFIX = "pathvariable:prefetched:";
+static constexpr const char *PATHVARIABLE_PREFETCHER_KEY = "scalarfs_pathvariable_prefetcher";
+
+// =============================================================================
+// PathVariablePrefetch Implementation
+// =============================================================================
+
+PathVariablePrefetch::PathVariablePrefetch(weak_ptr<ClientContext> context_p, weak_ptr<PathVariableIOPool> io_pool_p,
+                                           vector<string> paths_p, idx_t window_p, idx_t max_in_flight_p,
+                                           shared_ptr<std::atomic<idx_t>> used_bytes_p, idx_t max_bytes_p)
+    : context(std::move(context_p)), io_pool(std::move(io_pool_p)), paths(std::move(paths_p)), window(window_p),
+      max_in_flight(max_in_flight_p), used_bytes(std::move(used_bytes_p)), max_bytes(max_bytes_p),
+      states(paths.size(), FileState::PENDING), buffers(paths.size()) {
+}
+
+vector<idx_t> PathVariablePrefetch::Schedule() {
+	vector<idx_t> indexes;
+	while (!stopping && in_flight < max_in_flight && next_fetch < paths.size() && next_fetch < frontier + window) {
+		idx_t index = next_fetch++;
+		if (states[index] != FileState::PENDING) {
+			// Already opened directly
+			continue;
+		}
+		states[index] = FileState::FETCHING;
+		in_flight++;
+		indexes.push_back(index);
+	}
+	return indexes;
+}
+
+void PathVariablePrefetch::Submit(const vector<idx_t> &indexes) {
+	auto pool = io_pool.lock();
+	if (!pool) {
+		std::lock_guard<std::mutex> guard(lock);
+		for (auto index : indexes) {
+			states[index] = FileState::DIRECT;
+			in_flight--;
+		}
+		cv.notify_all();
+		return;
+	}
+	auto self = shared_from_this();
+	for (auto index : indexes) {
+		pool->Submit([self, index]() { self->FetchJob(index); });
+	}
+}
+
+void PathVariablePrefetch::FetchJob(idx_t index) {
+	bool stopped;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopped = stopping;
+	}
+	string data;
+	bool fetched = !stopped && Fetch(paths[index], data);
+
+	vector<idx_t> next;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		in_flight--;
+		if (fetched && !stopping) {
+			buffers[index] = std::move(data);
+			states[index] = FileState::READY;
+		} else {
+			if (fetched) {
+				// The query ended while the file was read
+				*used_bytes -= data.size();
+			}
+			states[index] = FileState::DIRECT;
+		}
+		next = Schedule();
+		cv.notify_all();
+	}
+	Submit(next);
+}
+
+bool PathVariablePrefetch::Fetch(const string &path, string &data) {
+	auto client_context = context.lock();
+	if (!client_context) {
+		return false;
+	}
+	auto &fs = FileSystem::GetFileSystem(*client_context);
+	idx_t reserved = 0;
+	try {
+		auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			return false;
+		}
+		idx_t size = handle->GetFileSize();
+		idx_t used = used_bytes->load();
+		do {
+			if (used + size > max_bytes) {
+				return false;
+			}
+		} while (!used_bytes->compare_exchange_weak(used, used + size));
+		reserved = size;
+
+		data.resize(size);
+		if (handle->CanSeek()) {
+			handle->Read(&data[0], size, 0);
+		} else {
+			idx_t offset = 0;
+			while (offset < size) {
+				auto bytes_read = handle->Read(&data[offset], size - offset);
+				if (bytes_read <= 0) {
+					break;
+				}
+				offset += NumericCast<idx_t>(bytes_read);
+			}
+			if (offset < size) {
+				*used_bytes -= reserved;
+				return false;
+			}
+		}
+		return true;
+	} catch (...) {
+		// Opened directly instead, which reports the error
+		*used_bytes -= reserved;
+		return false;
+	}
+}
+
+void PathVariablePrefetch::Release(idx_t index) {
+	if (states[index] == FileState::READY) {
+		*used_bytes -= buffers[index].size();
+		buffers[index] = string();
+		states[index] = FileState::DIRECT;
+	}
+}
+
+bool PathVariablePrefetch::Take(idx_t index, string &data) {
+	vector<idx_t> scheduled;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (index >= paths.size()) {
+			return false;
+		}
+		if (index + 1 > frontier) {
+			frontier = index + 1;
+			scheduled = Schedule();
+		}
+	}
+	Submit(scheduled);
+
+	std::unique_lock<std::mutex> guard(lock);
+	// A pending file inside the window is next in line once a fetch completes
+	cv.wait(guard, [&]() {
+		return states[index] != FileState::FETCHING &&
+		       (states[index] != FileState::PENDING || in_flight == 0 || stopping);
+	});
+
+	bool prefetched = false;
+	if (states[index] == FileState::READY) {
+		// Handed over: the buffer leaves the budget, and a second open of the
+		// file reads it directly
+		data = std::move(buffers[index]);
+		buffers[index] = string();
+		*used_bytes -= data.size();
+		prefetched = true;
+		states[index] = FileState::DIRECT;
+	} else if (states[index] == FileState::PENDING) {
+		states[index] = FileState::DIRECT;
+	}
+	// Release the buffers of files the scan skipped
+	while (released + window < index) {
+		Release(released++);
+	}
+	return prefetched;
+}
+
+void PathVariablePrefetch::Stop() {
+	std::lock_guard<std::mutex> guard(lock);
+	stopping = true;
+	for (idx_t i = 0; i < buffers.size(); i++) {
+		Release(i);
+	}
+	cv.notify_all();
+}
+
+bool PathVariablePrefetch::Matches(const vector<string> &other_paths) const {
+	return paths == other_paths;
+}
+
+// =============================================================================
+// PathVariablePrefetcher Implementation
+// =============================================================================
+
+PathVariablePrefetcher::~PathVariablePrefetcher() {
+	StopAll();
+}
+
+PathVariablePrefetcher &PathVariablePrefetcher::Get(ClientContext &context) {
+	return *context.registered_state->GetOrCreate<PathVariablePrefetcher>(PATHVARIABLE_PREFETCHER_KEY);
+}
+
+void PathVariablePrefetcher::AddPipeline(ClientContext &context, const shared_ptr<PathVariableIOPool> &io_pool,
+                                         vector<string> paths, idx_t window, idx_t max_in_flight,
+                                         shared_ptr<std::atomic<idx_t>> used_bytes, idx_t max_bytes) {
+	shared_ptr<PathVariablePrefetch> dropped;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		for (auto &pipeline : pipelines) {
+			if (pipeline->Matches(paths)) {
+				return;
+			}
+		}
+		if (pipelines.size() >= MAX_PIPELINES) {
+			// Oldest first
+			dropped = std::move(pipelines.front());
+			pipelines.erase(pipelines.begin());
+			for (auto entry = files.begin(); entry != files.end();) {
+				if (entry->second.pipeline == dropped) {
+					entry = files.erase(entry);
+				} else {
+					++entry;
+				}
+			}
+		}
+		auto pipeline = make_shared_ptr<PathVariablePrefetch>(context.shared_from_this(), io_pool, paths, window,
+		                                                      max_in_flight, std::move(used_bytes), max_bytes);
+		for (idx_t i = 0; i < paths.size(); i++) {
+			files[paths[i]] = PipelineEntry {pipeline, i};
+		}
+		pipelines.push_back(std::move(pipeline));
+	}
+	if (dropped) {
+		dropped->Stop();
+	}
+}
+
+bool PathVariablePrefetcher::Take(const string &path, string &data) {
+	PipelineEntry entry {nullptr, 0};
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto found = files.find(path);
+		if (found != files.end()) {
+			entry = found->second;
+		}
+	}
+	if (!entry.pipeline || !entry.pipeline->Take(entry.index, data)) {
+		files_read_directly++;
+		return false;
+	}
+	files_from_memory++;
+	bytes_from_memory += data.size();
+	return true;
+}
+
+void PathVariablePrefetcher::QueryEnd(ClientContext &context) {
+	StopAll();
+}
+
+void PathVariablePrefetcher::StopAll() {
+	vector<shared_ptr<PathVariablePrefetch>> stopped;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopped = std::move(pipelines);
+		pipelines.clear();
+		files.clear();
+	}
+	for (auto &pipeline : stopped) {
+		pipeline->Stop();
+	}
+}
+
+string PathVariablePrefetcher::GetPrefetchedPath(const string &path) {
+	return PREFETCHED_PREFIX + path;
+}
+
+bool PathVariablePrefetcher::IsPrefetchedPath(const string &path) {
+	return StringUtil::StartsWith(path, PREFETCHED_PREFIX);
+}
+
+bool PathVariablePrefetcher::ParsePrefetchedPath(const string &path, string &target) {
+	if (!IsPrefetchedPath(path)) {
+		return false;
+	}
+	target = path.substr(strlen(PREFETCHED_PREFIX));
+	return !target.empty();
+}
+
+uint64_t PathVariablePrefetcher::GetMaxMemory(ClientContext &context) {
+	Value max_memory;
+	if (context.TryGetCurrentSetting(MAX_MEMORY_SETTING, max_memory) && !max_memory.IsNull()) {
+		return max_memory.GetValue<uint64_t>();
+	}
+	return DEFAULT_MAX_MEMORY;
+}
+
+// =============================================================================
+// pathvariable_prefetch_stats()
+// =============================================================================
+
+struct PrefetchStatsScanState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> PrefetchStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"files_from_memory", "bytes_from_memory", "files_read_directly"};
+	return_types = {LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT};
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> PrefetchStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<PrefetchStatsScanState>();
+}
+
+static void PrefetchStatsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<PrefetchStatsScanState>();
+	if (state.done) {
+		return;
+	}
+	state.done = true;
+	auto &prefetcher = PathVariablePrefetcher::Get(context);
+	output.SetValue(0, 0, Value::UBIGINT(prefetcher.files_from_memory.load()));
+	output.SetValue(1, 0, Value::UBIGINT(prefetcher.bytes_from_memory.load()));
+	output.SetValue(2, 0, Value::UBIGINT(prefetcher.files_read_directly.load()));
+	output.SetCardinality(1);
+}
+
+void PathVariablePrefetcher::Register(ExtensionLoader &loader) {
+	TableFunction prefetch_stats("pathvariable_prefetch_stats", {}, PrefetchStatsScan, PrefetchStatsBind,
+	                             PrefetchStatsInit);
+	loader.RegisterFunction(prefetch_stats);
+}
+
+} // namespace duckdb
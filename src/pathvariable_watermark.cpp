@@ -0,0 +1,168 @@
+#include "pathvariable_watermark.hpp"
+#include "pathvariable_filesystem.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+static constexpr const char *PATHVARIABLE_WATERMARKS_KEY = "scalarfs_pathvariable_watermarks";
+
+PathVariableWatermarks &PathVariableWatermarks::Get(ClientContext &context) {
+	return *context.registered_state->GetOrCreate<PathVariableWatermarks>(PATHVARIABLE_WATERMARKS_KEY);
+}
+
+void PathVariableWatermarks::Record(const string &path, timestamp_t max_last_modified) {
+	std::lock_guard<std::mutex> guard(lock);
+	if (watermarks.size() >= MAX_ENTRIES && watermarks.find(path) == watermarks.end()) {
+		watermarks.clear();
+	}
+	watermarks[path] = max_last_modified;
+}
+
+bool PathVariableWatermarks::Lookup(const string &path, timestamp_t &max_last_modified) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = watermarks.find(path);
+	if (entry == watermarks.end()) {
+		return false;
+	}
+	max_last_modified = entry->second;
+	return true;
+}
+
+void PathVariableWatermarks::RecordLastModified(const string &file_path, timestamp_t last_modified) {
+	std::lock_guard<std::mutex> guard(lock);
+	if (file_last_modified.size() >= MAX_FILE_ENTRIES &&
+	    file_last_modified.find(file_path) == file_last_modified.end()) {
+		file_last_modified.clear();
+	}
+	file_last_modified[file_path] = last_modified;
+}
+
+bool PathVariableWatermarks::LookupLastModified(const string &file_path, timestamp_t &last_modified) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = file_last_modified.find(file_path);
+	if (entry == file_last_modified.end()) {
+		return false;
+	}
+	last_modified = entry->second;
+	return true;
+}
+
+bool PathVariableWatermarks::GetListedLastModified(const OpenFileInfo &info, timestamp_t &last_modified) {
+	// Remote filesystems (e.g. httpfs) attach the modification time found while listing
+	if (!info.extended_info) {
+		return false;
+	}
+	auto entry = info.extended_info->options.find("last_modified");
+	if (entry == info.extended_info->options.end()) {
+		return false;
+	}
+	return GetTimestampFromValue(entry->second, last_modified);
+}
+
+void PathVariableWatermarks::SetListedLastModified(OpenFileInfo &info, timestamp_t last_modified) {
+	if (!info.extended_info) {
+		info.extended_info = make_shared_ptr<ExtendedOpenFileInfo>();
+	}
+	info.extended_info->options["last_modified"] = Value::TIMESTAMP(last_modified);
+}
+
+bool PathVariableWatermarks::GetTimestampFromValue(const Value &value, timestamp_t &result) {
+	if (value.IsNull()) {
+		return false;
+	}
+	switch (value.type().id()) {
+	case LogicalTypeId::TIMESTAMP:
+	case LogicalTypeId::TIMESTAMP_TZ:
+		// Both are microseconds since the epoch (UTC for TIMESTAMPTZ)
+		result = value.GetValueUnsafe<timestamp_t>();
+		return true;
+	default:
+		result = value.DefaultCastAs(LogicalType::TIMESTAMP).GetValue<timestamp_t>();
+		return true;
+	}
+}
+
+// =============================================================================
+// pathvariable_max_mtime(path)
+// =============================================================================
+
+struct PathVariableMaxMTimeInfo : public ScalarFunctionInfo {
+	explicit PathVariableMaxMTimeInfo(shared_ptr<PathVariableIOPool> io_pool_p) : io_pool(std::move(io_pool_p)) {
+	}
+	// Lookups run on the pool of the pathvariable: filesystem
+	shared_ptr<PathVariableIOPool> io_pool;
+};
+
+static bool GetMaxLastModified(ClientContext &context, PathVariableIOPool &io_pool, const string &path,
+                               timestamp_t &result) {
+	auto &watermarks = PathVariableWatermarks::Get(context);
+	if (watermarks.Lookup(path, result)) {
+		return true;
+	}
+
+	// Not expanded yet - a since! expansion records its own watermark
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto files = fs.Glob(path);
+	if (watermarks.Lookup(path, result)) {
+		return true;
+	}
+
+	// Times from the listing, or looked up by an earlier expansion of the
+	// files; the rest are looked up concurrently
+	vector<timestamp_t> last_modified(files.size());
+	vector<uint8_t> exists(files.size(), 1);
+	vector<idx_t> unknown;
+	for (idx_t i = 0; i < files.size(); i++) {
+		if (!PathVariableWatermarks::GetListedLastModified(files[i], last_modified[i]) &&
+		    !watermarks.LookupLastModified(files[i].path, last_modified[i])) {
+			unknown.push_back(i);
+		}
+	}
+	io_pool.Run(unknown.size(), PathVariableFileSystem::GetIOParallelism(context), [&](idx_t task) {
+		auto index = unknown[task];
+		auto flags = FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS;
+		auto handle = fs.OpenFile(files[index].path, flags);
+		if (!handle) {
+			exists[index] = 0;
+			return true;
+		}
+		last_modified[index] = fs.GetLastModifiedTime(*handle);
+		return true;
+	});
+
+	bool found = false;
+	for (idx_t i = 0; i < files.size(); i++) {
+		if (exists[i] && (!found || last_modified[i] > result)) {
+			result = last_modified[i];
+			found = true;
+		}
+	}
+	return found;
+}
+
+static void MaxMTimeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.function.function_info->Cast<PathVariableMaxMTimeInfo>();
+	auto &context = state.GetContext();
+	UnaryExecutor::ExecuteWithNulls<string_t, timestamp_t>(
+	    args.data[0], result, args.size(), [&](string_t path, ValidityMask &mask, idx_t idx) {
+		    timestamp_t max_last_modified;
+		    if (!GetMaxLastModified(context, *info.io_pool, path.GetString(), max_last_modified)) {
+			    mask.SetInvalid(idx);
+			    return timestamp_t(0);
+		    }
+		    return max_last_modified;
+	    });
+}
+
+void PathVariableWatermarks::Register(ExtensionLoader &loader, shared_ptr<PathVariableIOPool> io_pool) {
+	ScalarFunction max_mtime("pathvariable_max_mtime", {LogicalType::VARCHAR}, LogicalType::TIMESTAMP,
+	                         MaxMTimeFunction);
+	max_mtime.stability = FunctionStability::VOLATILE;
+	max_mtime.function_info = make_shared_ptr<PathVariableMaxMTimeInfo>(std::move(io_pool));
+	loader.RegisterFunction(max_mtime);
+}
+
+} // namespace duckdb
@@ -0,0 +1,440 @@
+#include "read_variable_function.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/main/client_config.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/null_filter.hpp"
+#include "duckdb/planner/filter/struct_filter.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+namespace duckdb {
+
+// =============================================================================
+// Global State
+// =============================================================================
+
+struct ReadVariableGlobalState : public GlobalTableFunctionState {
+	// Number of rows handed out per range (one output chunk)
+	static constexpr idx_t RANGE_SIZE = STANDARD_VECTOR_SIZE;
+
+	ReadVariableGlobalState(idx_t row_count_p, idx_t chunk_count_p, vector<column_t> column_ids_p,
+	                        optional_ptr<TableFilterSet> filters_p)
+	    : row_count(row_count_p), chunk_count(chunk_count_p), column_ids(std::move(column_ids_p)), filters(filters_p),
+	      next_row(0), next_chunk(0) {
+	}
+
+	idx_t row_count;
+	// NATIVE layout: number of serialized chunks (0 otherwise)
+	idx_t chunk_count;
+	// Projected columns (indexes into the variable's columns)
+	vector<column_t> column_ids;
+	// Pushed-down filters, keyed by index into column_ids
+	optional_ptr<TableFilterSet> filters;
+	// Start of the next unclaimed row range
+	atomic<idx_t> next_row;
+	// NATIVE layout: index of the next unclaimed chunk
+	atomic<idx_t> next_chunk;
+
+	idx_t MaxThreads() const override {
+		if (chunk_count > 0) {
+			return chunk_count;
+		}
+		return MaxValue<idx_t>((row_count + RANGE_SIZE - 1) / RANGE_SIZE, 1);
+	}
+};
+
+struct ReadVariableLocalState : public LocalTableFunctionState {
+	// NATIVE layout: the most recently deserialized chunk
+	DataChunk chunk;
+};
+
+// =============================================================================
+// Helper Functions
+// =============================================================================
+
+static bool IsColumnarStruct(const Value &value, idx_t &row_count) {
+	// A non-empty STRUCT whose fields are all LISTs of the same length
+	auto &type = value.type();
+	if (type.id() != LogicalTypeId::STRUCT || StructType::GetChildCount(type) == 0) {
+		return false;
+	}
+	auto &fields = StructValue::GetChildren(value);
+	for (idx_t i = 0; i < fields.size(); i++) {
+		if (fields[i].type().id() != LogicalTypeId::LIST || fields[i].IsNull()) {
+			return false;
+		}
+		idx_t len = ListValue::GetChildren(fields[i]).size();
+		if (i == 0) {
+			row_count = len;
+		} else if (len != row_count) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Fetch a single cell of the variable, interpreted according to its layout
+static Value GetCell(const ReadVariableBindData &bind_data, idx_t row_idx, idx_t col_idx) {
+	auto &value = bind_data.value;
+	switch (bind_data.layout) {
+	case ReadVariableLayout::SCALAR:
+		return value;
+	case ReadVariableLayout::STRUCT:
+		return StructValue::GetChildren(value)[col_idx];
+	case ReadVariableLayout::VALUES:
+		return ListValue::GetChildren(value)[row_idx];
+	case ReadVariableLayout::ROWS: {
+		auto &row = ListValue::GetChildren(value)[row_idx];
+		if (row.IsNull()) {
+			return Value(bind_data.types[col_idx]);
+		}
+		return StructValue::GetChildren(row)[col_idx];
+	}
+	case ReadVariableLayout::COLUMNS:
+		return ListValue::GetChildren(StructValue::GetChildren(value)[col_idx])[row_idx];
+	case ReadVariableLayout::NATIVE:
+		throw InternalException("read_variable: native data is scanned by chunk, not by cell");
+	default:
+		throw InternalException("Unsupported read_variable layout");
+	}
+}
+
+// Evaluate a pushed-down table filter against a single value
+static bool EvaluateFilter(ClientContext &context, const TableFilter &filter, const Value &value) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON:
+		if (value.IsNull()) {
+			return false;
+		}
+		return filter.Cast<ConstantFilter>().Compare(value);
+	case TableFilterType::IS_NULL:
+		return value.IsNull();
+	case TableFilterType::IS_NOT_NULL:
+		return !value.IsNull();
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &conjunction = filter.Cast<ConjunctionAndFilter>();
+		for (auto &child : conjunction.child_filters) {
+			if (!EvaluateFilter(context, *child, value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &conjunction = filter.Cast<ConjunctionOrFilter>();
+		for (auto &child : conjunction.child_filters) {
+			if (EvaluateFilter(context, *child, value)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	case TableFilterType::STRUCT_EXTRACT: {
+		auto &struct_filter = filter.Cast<StructFilter>();
+		if (value.IsNull()) {
+			return EvaluateFilter(context, *struct_filter.child_filter,
+			                      Value(StructType::GetChildType(value.type(), struct_filter.child_idx)));
+		}
+		return EvaluateFilter(context, *struct_filter.child_filter,
+		                      StructValue::GetChildren(value)[struct_filter.child_idx]);
+	}
+	case TableFilterType::IN_FILTER: {
+		if (value.IsNull()) {
+			return false;
+		}
+		for (auto &in_value : filter.Cast<InFilter>().values) {
+			if (in_value == value) {
+				return true;
+			}
+		}
+		return false;
+	}
+	case TableFilterType::EXPRESSION_FILTER:
+		return filter.Cast<ExpressionFilter>().EvaluateWithConstant(context, value);
+	case TableFilterType::OPTIONAL_FILTER:
+	case TableFilterType::DYNAMIC_FILTER:
+	default:
+		// Pruning hints (and filter types this scan does not know): keep the
+		// row, the plan still applies the real predicate
+		return true;
+	}
+}
+
+static bool RowMatchesFilters(ClientContext &context, const ReadVariableBindData &bind_data,
+                              const ReadVariableGlobalState &gstate, idx_t row_idx) {
+	for (auto &entry : gstate.filters->filters) {
+		auto col_idx = gstate.column_ids[entry.first];
+		if (IsVirtualColumn(col_idx)) {
+			continue;
+		}
+		if (!EvaluateFilter(context, *entry.second, GetCell(bind_data, row_idx, col_idx))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// =============================================================================
+// Bind
+// =============================================================================
+
+unique_ptr<FunctionData> ReadVariableFunction::Bind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs[0].IsNull()) {
+		throw BinderException("read_variable: variable name cannot be NULL");
+	}
+	string var_name = input.inputs[0].ToString();
+
+	bool columnar = true;
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "columnar") {
+			columnar = BooleanValue::Get(kv.second);
+		}
+	}
+
+	auto &config = ClientConfig::GetConfig(context);
+	Value value;
+	if (!config.GetUserVariable(var_name, value)) {
+		throw BinderException("Variable '%s' not found", var_name);
+	}
+	if (value.IsNull()) {
+		throw BinderException("Variable '%s' is NULL", var_name);
+	}
+
+	auto &type = value.type();
+	ReadVariableLayout layout;
+	idx_t row_count = 1;
+
+	if (type.id() == LogicalTypeId::BLOB && ScalarfsNativeFormat::IsNative(StringValue::Get(value))) {
+		// Written by FORMAT scalarfs_native - schema comes from the footer
+		auto native_data = StringValue::Get(value);
+		auto footer = ScalarfsNativeFormat::ReadFooter(native_data);
+		names = footer.names;
+		return_types = footer.types;
+
+		auto result = make_uniq<ReadVariableBindData>(var_name, Value(), ReadVariableLayout::NATIVE,
+		                                              footer.row_count, return_types);
+		result->native_data = std::move(native_data);
+		idx_t row_start = 0;
+		for (auto chunk_rows : footer.chunk_rows) {
+			result->native_row_starts.push_back(row_start);
+			row_start += chunk_rows;
+		}
+		result->native_footer = std::move(footer);
+		return std::move(result);
+	}
+
+	if (type.id() == LogicalTypeId::LIST) {
+		auto &child_type = ListType::GetChildType(type);
+		row_count = ListValue::GetChildren(value).size();
+		if (child_type.id() == LogicalTypeId::STRUCT) {
+			layout = ReadVariableLayout::ROWS;
+			for (auto &child : StructType::GetChildTypes(child_type)) {
+				names.push_back(child.first);
+				return_types.push_back(child.second);
+			}
+		} else {
+			layout = ReadVariableLayout::VALUES;
+			names.emplace_back("value");
+			return_types.push_back(child_type);
+		}
+	} else if (type.id() == LogicalTypeId::STRUCT) {
+		if (columnar && IsColumnarStruct(value, row_count)) {
+			layout = ReadVariableLayout::COLUMNS;
+			for (auto &child : StructType::GetChildTypes(type)) {
+				names.push_back(child.first);
+				return_types.push_back(ListType::GetChildType(child.second));
+			}
+		} else {
+			layout = ReadVariableLayout::STRUCT;
+			row_count = 1;
+			for (auto &child : StructType::GetChildTypes(type)) {
+				names.push_back(child.first);
+				return_types.push_back(child.second);
+			}
+		}
+	} else {
+		layout = ReadVariableLayout::SCALAR;
+		names.emplace_back("value");
+		return_types.push_back(type);
+	}
+
+	if (return_types.empty()) {
+		throw BinderException("Variable '%s' has no columns to read", var_name);
+	}
+
+	return make_uniq<ReadVariableBindData>(var_name, std::move(value), layout, row_count, return_types);
+}
+
+// =============================================================================
+// Initialize Global State
+// =============================================================================
+
+unique_ptr<GlobalTableFunctionState> ReadVariableFunction::InitGlobal(ClientContext &context,
+                                                                      TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ReadVariableBindData>();
+	return make_uniq<ReadVariableGlobalState>(bind_data.row_count, bind_data.native_footer.chunk_offsets.size(),
+	                                          input.column_ids, input.filters);
+}
+
+// =============================================================================
+// Initialize Local State
+// =============================================================================
+
+unique_ptr<LocalTableFunctionState> ReadVariableFunction::InitLocal(ExecutionContext &context,
+                                                                    TableFunctionInitInput &input,
+                                                                    GlobalTableFunctionState *global_state) {
+	return make_uniq<ReadVariableLocalState>();
+}
+
+// =============================================================================
+// ScanNative - Deserialize one chunk per call
+// =============================================================================
+
+void ReadVariableFunction::ScanNative(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<ReadVariableBindData>();
+	auto &gstate = data.global_state->Cast<ReadVariableGlobalState>();
+	auto &lstate = data.local_state->Cast<ReadVariableLocalState>();
+	auto &footer = bind_data.native_footer;
+	bool has_filters = gstate.filters && !gstate.filters->filters.empty();
+
+	while (true) {
+		idx_t chunk_idx = gstate.next_chunk++;
+		if (chunk_idx >= gstate.chunk_count) {
+			output.SetCardinality(0);
+			return;
+		}
+
+		auto &chunk = lstate.chunk;
+		chunk.Destroy();
+		ScalarfsNativeFormat::ReadChunk(bind_data.native_data, footer, chunk_idx, chunk);
+
+		// Projected columns reference the deserialized vectors - no copy
+		for (idx_t out_col = 0; out_col < gstate.column_ids.size(); out_col++) {
+			auto col_idx = gstate.column_ids[out_col];
+			auto &vec = output.data[out_col];
+			if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+				vec.Sequence(NumericCast<int64_t>(bind_data.native_row_starts[chunk_idx]), 1, chunk.size());
+			} else if (IsVirtualColumn(col_idx)) {
+				vec.Reference(Value(vec.GetType()));
+			} else {
+				vec.Reference(chunk.data[col_idx]);
+			}
+		}
+		output.SetCardinality(chunk.size());
+
+		if (!has_filters) {
+			return;
+		}
+
+		SelectionVector sel(chunk.size());
+		idx_t selected = 0;
+		for (idx_t row_idx = 0; row_idx < chunk.size(); row_idx++) {
+			bool matches = true;
+			for (auto &entry : gstate.filters->filters) {
+				auto col_idx = gstate.column_ids[entry.first];
+				if (IsVirtualColumn(col_idx)) {
+					continue;
+				}
+				if (!EvaluateFilter(context, *entry.second, chunk.data[col_idx].GetValue(row_idx))) {
+					matches = false;
+					break;
+				}
+			}
+			if (matches) {
+				sel.set_index(selected++, row_idx);
+			}
+		}
+		if (selected == 0) {
+			// Whole chunk filtered out - an empty chunk would end the scan, so move on
+			output.Reset();
+			continue;
+		}
+		if (selected < chunk.size()) {
+			output.Slice(sel, selected);
+		}
+		return;
+	}
+}
+
+// =============================================================================
+// Scan - Produce one row range per call
+// =============================================================================
+
+void ReadVariableFunction::Scan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<ReadVariableBindData>();
+	auto &gstate = data.global_state->Cast<ReadVariableGlobalState>();
+	if (bind_data.layout == ReadVariableLayout::NATIVE) {
+		ScanNative(context, data, output);
+		return;
+	}
+	bool has_filters = gstate.filters && !gstate.filters->filters.empty();
+
+	vector<idx_t> selected_rows;
+	selected_rows.reserve(ReadVariableGlobalState::RANGE_SIZE);
+
+	// Keep claiming ranges until one yields rows: an empty chunk signals the end of the scan
+	while (selected_rows.empty()) {
+		idx_t start = gstate.next_row.fetch_add(ReadVariableGlobalState::RANGE_SIZE);
+		if (start >= bind_data.row_count) {
+			break;
+		}
+		idx_t end = MinValue<idx_t>(start + ReadVariableGlobalState::RANGE_SIZE, bind_data.row_count);
+
+		// Filter first so rejected rows never have their projected columns materialized
+		for (idx_t row_idx = start; row_idx < end; row_idx++) {
+			if (!has_filters || RowMatchesFilters(context, bind_data, gstate, row_idx)) {
+				selected_rows.push_back(row_idx);
+			}
+		}
+	}
+
+	for (idx_t out_col = 0; out_col < gstate.column_ids.size(); out_col++) {
+		auto col_idx = gstate.column_ids[out_col];
+		auto &vec = output.data[out_col];
+		for (idx_t out_idx = 0; out_idx < selected_rows.size(); out_idx++) {
+			if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+				vec.SetValue(out_idx, Value::BIGINT(NumericCast<int64_t>(selected_rows[out_idx])));
+			} else if (IsVirtualColumn(col_idx)) {
+				vec.SetValue(out_idx, Value(vec.GetType()));
+			} else {
+				vec.SetValue(out_idx, GetCell(bind_data, selected_rows[out_idx], col_idx));
+			}
+		}
+	}
+	output.SetCardinality(selected_rows.size());
+}
+
+// =============================================================================
+// Cardinality
+// =============================================================================
+
+unique_ptr<NodeStatistics> ReadVariableFunction::Cardinality(ClientContext &context, const FunctionData *bind_data) {
+	auto &data = bind_data->Cast<ReadVariableBindData>();
+	return make_uniq<NodeStatistics>(data.row_count, data.row_count);
+}
+
+// =============================================================================
+// Register the Table Function
+// =============================================================================
+
+TableFunction ReadVariableFunction::GetFunction() {
+	TableFunction func("read_variable", {LogicalType::VARCHAR}, Scan, Bind, InitGlobal, InitLocal);
+	func.named_parameters["columnar"] = LogicalType::BOOLEAN;
+	func.cardinality = Cardinality;
+	func.projection_pushdown = true;
+	func.filter_pushdown = true;
+	return func;
+}
+
+void ReadVariableFunction::Register(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetFunction());
+}
+
+} // namespace duckdb
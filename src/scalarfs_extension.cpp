@@ -4,12 +4,15 @@
 #include "data_uri_filesystem.hpp"
 #include "variable_filesystem.hpp"
 #include "pathvariable_filesystem.hpp"
+#include "pathvariable_watermark.hpp"
 #include "decompress_filesystem.hpp"
 #include "variable_copy_function.hpp"
+#include "read_variable_function.hpp"
 #include "scalarfs_functions.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/main/database.hpp"
 
 namespace duckdb {
@@ -26,7 +29,12 @@ static void LoadInternal(ExtensionLoader &loader) {
 	fs.RegisterSubSystem(make_uniq<VariableFileSystem>());
 
 	// Register the path variable filesystem (handles pathvariable:)
-	fs.RegisterSubSystem(make_uniq<PathVariableFileSystem>());
+	auto pathvariable_fs = make_uniq<PathVariableFileSystem>();
+	auto glob_cache = pathvariable_fs->GetGlobCache();
+	auto missing_cache = pathvariable_fs->GetMissingCache();
+	auto disk_cache = pathvariable_fs->GetDiskCache();
+	auto io_pool = pathvariable_fs->GetIOPool();
+	fs.RegisterSubSystem(std::move(pathvariable_fs));
 
 	// Register the decompress filesystem (handles decompress+gz:, decompress+zstd:)
 	fs.RegisterSubSystem(make_uniq<DecompressFileSystem>());
@@ -34,6 +42,33 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register the variable copy function (FORMAT variable)
 	VariableCopyFunction::Register(loader);
 
+	// Register the read_variable table function (scans FORMAT variable results)
+	ReadVariableFunction::Register(loader);
+
+	// Register pathvariable: settings
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption(PathVariableFileSystem::IO_PARALLELISM_SETTING,
+	                          "Maximum concurrent filesystem requests per pathvariable: glob (1 disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(PathVariableFileSystem::DEFAULT_IO_PARALLELISM));
+	config.AddExtensionOption(PathVariableFileSystem::CAPTURE_MAX_SIZE_SETTING,
+	                          "Largest file in bytes pathvariable:capture keeps in its variable",
+	                          LogicalType::UBIGINT, Value::UBIGINT(PathVariableFileSystem::DEFAULT_CAPTURE_MAX_SIZE));
+	config.AddExtensionOption(PathVariablePrefetcher::MAX_MEMORY_SETTING,
+	                          "Memory in bytes for files read ahead by pathvariable:prefetch: (0 disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(PathVariablePrefetcher::DEFAULT_MAX_MEMORY));
+
+	// Register the pathvariable: cache settings and pathvariable_clear_cache()
+	PathVariableGlobCache::Register(loader, std::move(glob_cache), std::move(missing_cache));
+
+	// Register the pathvariable:cache: settings, pathvariable_disk_cache() and pathvariable_clear_disk_cache()
+	PathVariableDiskCache::Register(loader, std::move(disk_cache));
+
+	// Register pathvariable_max_mtime() (watermarks of the since modifier)
+	PathVariableWatermarks::Register(loader, std::move(io_pool));
+
+	// Register pathvariable_prefetch_stats() (files served by the prefetch modifier)
+	PathVariablePrefetcher::Register(loader);
+
 	// Register scalar functions for encoding/decoding URIs
 	ScalarfsFunctions::Register(loader);
 }
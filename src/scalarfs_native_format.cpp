@@ -0,0 +1,129 @@
+#include "scalarfs_native_format.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/serializer/binary_deserializer.hpp"
+#include "duckdb/common/serializer/binary_serializer.hpp"
+#include "duckdb/common/serializer/memory_stream.hpp"
+
+namespace duckdb {
+
+string ScalarfsNativeFormat::Serialize(ColumnDataCollection &results, const vector<string> &names) {
+	MemoryStream stream;
+	stream.WriteData(const_data_ptr_cast(MAGIC), MAGIC_SIZE);
+
+	ScalarfsNativeFooter footer;
+	footer.names = names;
+	footer.types = results.Types();
+	footer.row_count = results.Count();
+
+	// Serialize each chunk as its own object so it can be read independently
+	DataChunk chunk;
+	chunk.Initialize(Allocator::DefaultAllocator(), results.Types());
+
+	ColumnDataScanState scan_state;
+	results.InitializeScan(scan_state);
+
+	while (results.Scan(scan_state, chunk)) {
+		footer.chunk_offsets.push_back(stream.GetPosition());
+		footer.chunk_rows.push_back(chunk.size());
+
+		BinarySerializer serializer(stream);
+		serializer.Begin();
+		chunk.Serialize(serializer);
+		serializer.End();
+
+		chunk.Reset();
+	}
+
+	// Footer, followed by its offset and the trailing magic
+	idx_t footer_offset = stream.GetPosition();
+	BinarySerializer serializer(stream);
+	serializer.Begin();
+	serializer.WriteProperty(100, "names", footer.names);
+	serializer.WriteProperty(101, "types", footer.types);
+	serializer.WriteProperty(102, "chunk_offsets", footer.chunk_offsets);
+	serializer.WriteProperty(103, "chunk_rows", footer.chunk_rows);
+	serializer.WriteProperty(104, "row_count", footer.row_count);
+	serializer.End();
+
+	stream.Write<uint64_t>(footer_offset);
+	stream.WriteData(const_data_ptr_cast(MAGIC), MAGIC_SIZE);
+
+	return string(const_char_ptr_cast(stream.GetData()), stream.GetPosition());
+}
+
+bool ScalarfsNativeFormat::IsNative(const string &data) {
+	if (data.size() < MAGIC_SIZE * 2 + sizeof(uint64_t)) {
+		return false;
+	}
+	return memcmp(data.data(), MAGIC, MAGIC_SIZE) == 0 &&
+	       memcmp(data.data() + data.size() - MAGIC_SIZE, MAGIC, MAGIC_SIZE) == 0;
+}
+
+ScalarfsNativeFooter ScalarfsNativeFormat::ReadFooter(const string &data) {
+	if (!IsNative(data)) {
+		throw InvalidInputException("Data is not in scalarfs_native format");
+	}
+
+	uint64_t footer_offset;
+	memcpy(&footer_offset, data.data() + data.size() - MAGIC_SIZE - sizeof(uint64_t), sizeof(uint64_t));
+	idx_t footer_end = data.size() - MAGIC_SIZE - sizeof(uint64_t);
+	if (footer_offset < MAGIC_SIZE || footer_offset >= footer_end) {
+		throw InvalidInputException("Corrupt scalarfs_native data: invalid footer offset");
+	}
+
+	// MemoryStream only reads from the buffer, it never writes to it
+	auto buffer = data_ptr_cast(const_cast<char *>(data.data()));
+	MemoryStream stream(buffer + footer_offset, footer_end - footer_offset);
+
+	ScalarfsNativeFooter footer;
+	BinaryDeserializer deserializer(stream);
+	deserializer.Begin();
+	footer.names = deserializer.ReadProperty<vector<string>>(100, "names");
+	footer.types = deserializer.ReadProperty<vector<LogicalType>>(101, "types");
+	footer.chunk_offsets = deserializer.ReadProperty<vector<idx_t>>(102, "chunk_offsets");
+	footer.chunk_rows = deserializer.ReadProperty<vector<idx_t>>(103, "chunk_rows");
+	footer.row_count = deserializer.ReadProperty<idx_t>(104, "row_count");
+	deserializer.End();
+
+	if (footer.names.size() != footer.types.size() || footer.chunk_offsets.size() != footer.chunk_rows.size()) {
+		throw InvalidInputException("Corrupt scalarfs_native data: inconsistent footer");
+	}
+	for (auto offset : footer.chunk_offsets) {
+		if (offset < MAGIC_SIZE || offset >= footer_offset) {
+			throw InvalidInputException("Corrupt scalarfs_native data: invalid chunk offset");
+		}
+	}
+	return footer;
+}
+
+void ScalarfsNativeFormat::ReadChunk(const string &data, const ScalarfsNativeFooter &footer, idx_t chunk_idx,
+                                     DataChunk &chunk) {
+	auto offset = footer.chunk_offsets[chunk_idx];
+	auto buffer = data_ptr_cast(const_cast<char *>(data.data()));
+	MemoryStream stream(buffer + offset, data.size() - offset);
+
+	BinaryDeserializer deserializer(stream);
+	deserializer.Begin();
+	chunk.Deserialize(deserializer);
+	deserializer.End();
+
+	// Scans reference the columns by the footer's schema - a chunk that
+	// disagrees with it must not reach them
+	if (chunk.ColumnCount() != footer.types.size()) {
+		throw InvalidInputException("Corrupt scalarfs_native data: chunk %d has %d columns, expected %d", chunk_idx,
+		                            chunk.ColumnCount(), footer.types.size());
+	}
+	for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+		if (chunk.data[col_idx].GetType() != footer.types[col_idx]) {
+			throw InvalidInputException("Corrupt scalarfs_native data: chunk %d column %d is %s, expected %s",
+			                            chunk_idx, col_idx, chunk.data[col_idx].GetType().ToString(),
+			                            footer.types[col_idx].ToString());
+		}
+	}
+	if (chunk.size() != footer.chunk_rows[chunk_idx]) {
+		throw InvalidInputException("Corrupt scalarfs_native data: chunk %d has %d rows, expected %d", chunk_idx,
+		                            chunk.size(), footer.chunk_rows[chunk_idx]);
+	}
+}
+
+} // namespace duckdb
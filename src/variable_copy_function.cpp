@@ -1,10 +1,15 @@
 #include "variable_copy_function.hpp"
+#include "scalarfs_native_format.hpp"
+#include "variable_name_index.hpp"
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/value.hpp"
+#include "duckdb/common/types/value_map.hpp"
 #include "duckdb/main/client_config.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include <algorithm>
 
 namespace duckdb {
 
@@ -20,6 +25,38 @@ string VariableCopyFunction::ExtractVariableName(const string &path) {
 	return path.substr(9); // len("variable:")
 }
 
+idx_t VariableCopyFunction::ParseLimitOption(const string &name, const vector<Value> &values, bool is_bytes) {
+	if (values.size() != 1) {
+		throw BinderException("%s option requires a single value", name);
+	}
+	auto &value = values[0];
+	if (value.IsNull()) {
+		throw BinderException("%s option cannot be NULL", name);
+	}
+	if (is_bytes && value.type().id() == LogicalTypeId::VARCHAR) {
+		// Accept memory-limit style strings such as '64MB' or '1GiB'
+		return DBConfig::ParseMemoryLimit(value.ToString());
+	}
+	auto limit = value.GetValue<int64_t>();
+	if (limit < 0) {
+		throw BinderException("%s option must be non-negative, got %d", name, limit);
+	}
+	return static_cast<idx_t>(limit);
+}
+
+void VariableCopyFunction::CheckLimits(const VariableCopyBindData &bind_data, idx_t row_count, idx_t byte_count) {
+	if (bind_data.list_mode == VariableCopyListMode::NONE && row_count > 1) {
+		throw InvalidInputException("LIST none mode requires single row result, got at least %d rows", row_count);
+	}
+	if (bind_data.max_rows != DConstants::INVALID_INDEX && row_count > bind_data.max_rows) {
+		throw InvalidInputException("FORMAT variable result exceeds MAX_ROWS limit of %d rows", bind_data.max_rows);
+	}
+	if (bind_data.max_bytes != DConstants::INVALID_INDEX && byte_count > bind_data.max_bytes) {
+		throw InvalidInputException("FORMAT variable result exceeds MAX_BYTES limit of %d bytes (buffered %d bytes)",
+		                            bind_data.max_bytes, byte_count);
+	}
+}
+
 // =============================================================================
 // Bind
 // =============================================================================
@@ -33,8 +70,14 @@ unique_ptr<FunctionData> VariableCopyFunction::Bind(ClientContext &context, Copy
 		throw BinderException("Variable name cannot be empty");
 	}
 
-	// Parse LIST option
+	// Parse LIST and limit options
 	VariableCopyListMode list_mode = VariableCopyListMode::AUTO;
+	idx_t max_rows = DConstants::INVALID_INDEX;
+	idx_t max_bytes = DConstants::INVALID_INDEX;
+	bool append = false;
+	string key_name;
+	idx_t limit = DConstants::INVALID_INDEX;
+	idx_t sample_size = DConstants::INVALID_INDEX;
 
 	for (auto &option : input.info.options) {
 		string loption = StringUtil::Lower(option.first);
@@ -54,18 +97,99 @@ unique_ptr<FunctionData> VariableCopyFunction::Bind(ClientContext &context, Copy
 				list_mode = VariableCopyListMode::NONE;
 			} else if (mode_str == "scalar") {
 				list_mode = VariableCopyListMode::SCALAR;
+			} else if (mode_str == "columns") {
+				list_mode = VariableCopyListMode::COLUMNS;
+			} else if (mode_str == "map") {
+				list_mode = VariableCopyListMode::MAP;
 			} else {
-				throw BinderException("Invalid LIST mode '%s'. Valid options: auto, rows, none, scalar", mode_str);
+				throw BinderException("Invalid LIST mode '%s'. Valid options: auto, rows, none, scalar, columns, map",
+				                      mode_str);
+			}
+		} else if (loption == "max_rows") {
+			max_rows = ParseLimitOption("MAX_ROWS", values, false);
+		} else if (loption == "max_bytes") {
+			max_bytes = ParseLimitOption("MAX_BYTES", values, true);
+		} else if (loption == "append") {
+			if (values.size() > 1) {
+				throw BinderException("APPEND option requires at most one value");
 			}
+			append = values.empty() || BooleanValue::Get(values[0].DefaultCastAs(LogicalType::BOOLEAN));
+		} else if (loption == "limit") {
+			limit = ParseLimitOption("LIMIT", values, false);
+		} else if (loption == "sample") {
+			sample_size = ParseLimitOption("SAMPLE", values, false);
+		} else if (loption == "key") {
+			if (values.size() != 1) {
+				throw BinderException("KEY option requires a single column name");
+			}
+			key_name = values[0].ToString();
 		}
 	}
 
+	if (append && list_mode == VariableCopyListMode::NONE) {
+		throw BinderException("APPEND cannot be combined with LIST none");
+	}
+
+	if (limit != DConstants::INVALID_INDEX && sample_size != DConstants::INVALID_INDEX) {
+		throw BinderException("LIMIT and SAMPLE options cannot be combined");
+	}
+
+	// Validate LIST map mode and resolve the key column
+	idx_t key_column = 0;
+	if (list_mode == VariableCopyListMode::MAP) {
+		if (sql_types.size() < 2) {
+			throw BinderException("LIST map mode requires at least two columns (key and value), got %d",
+			                      sql_types.size());
+		}
+		if (append) {
+			throw BinderException("APPEND cannot be combined with LIST map");
+		}
+		if (!key_name.empty()) {
+			key_column = DConstants::INVALID_INDEX;
+			for (idx_t i = 0; i < names.size(); i++) {
+				if (StringUtil::CIEquals(names[i], key_name)) {
+					key_column = i;
+					break;
+				}
+			}
+			if (key_column == DConstants::INVALID_INDEX) {
+				throw BinderException("KEY column '%s' not found in COPY result", key_name);
+			}
+		}
+	} else if (!key_name.empty()) {
+		throw BinderException("KEY option is only supported with LIST map");
+	}
+
 	// Validate LIST scalar mode
 	if (list_mode == VariableCopyListMode::SCALAR && sql_types.size() > 1) {
 		throw BinderException("LIST scalar mode requires single-column result, got %d columns", sql_types.size());
 	}
 
-	return make_uniq<VariableCopyBindData>(var_name, list_mode, names, sql_types);
+	auto result = make_uniq<VariableCopyBindData>(var_name, list_mode, names, sql_types);
+	result->max_rows = max_rows;
+	result->max_bytes = max_bytes;
+	result->append = append;
+	result->key_column = key_column;
+	result->limit = limit;
+	result->sample_size = sample_size;
+	return std::move(result);
+}
+
+unique_ptr<FunctionData> VariableCopyFunction::NativeBind(ClientContext &context, CopyFunctionBindInput &input,
+                                                          const vector<string> &names,
+                                                          const vector<LogicalType> &sql_types) {
+	// The native format always stores the full table - LIST modes and APPEND do not apply
+	for (auto &option : input.info.options) {
+		auto loption = StringUtil::Lower(option.first);
+		if (loption == "list" || loption == "append") {
+			throw BinderException("%s option is not supported by FORMAT scalarfs_native",
+			                      StringUtil::Upper(loption));
+		}
+	}
+
+	auto result = Bind(context, input, names, sql_types);
+	result->Cast<VariableCopyBindData>().native = true;
+	return result;
 }
 
 // =============================================================================
@@ -91,26 +215,226 @@ unique_ptr<LocalFunctionData> VariableCopyFunction::InitializeLocal(ExecutionCon
 	return make_uniq<VariableCopyLocalState>();
 }
 
+// =============================================================================
+// Reservoir Sampling (SAMPLE n)
+// =============================================================================
+
+// Heap comparator: the row with the smallest key sits at the front of the reservoir
+static bool SampleRowHasLargerKey(const VariableCopySampleRow &a, const VariableCopySampleRow &b) {
+	return a.key > b.key;
+}
+
+void VariableCopyFunction::AddToReservoir(vector<VariableCopySampleRow> &reservoir, idx_t sample_size,
+                                          VariableCopySampleRow row) {
+	// Keeping the rows with the n largest uniform random keys yields a uniform sample,
+	// and two such reservoirs merge by simply re-adding one into the other
+	if (reservoir.size() < sample_size) {
+		reservoir.push_back(std::move(row));
+		std::push_heap(reservoir.begin(), reservoir.end(), SampleRowHasLargerKey);
+		return;
+	}
+	if (sample_size == 0 || row.key <= reservoir.front().key) {
+		return;
+	}
+	std::pop_heap(reservoir.begin(), reservoir.end(), SampleRowHasLargerKey);
+	reservoir.back() = std::move(row);
+	std::push_heap(reservoir.begin(), reservoir.end(), SampleRowHasLargerKey);
+}
+
+void VariableCopyFunction::SinkSample(const VariableCopyBindData &bind_data, VariableCopyLocalState &state,
+                                      DataChunk &input) {
+	idx_t col_count = input.ColumnCount();
+	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
+		double key = state.random.NextRandom();
+		if (state.reservoir.size() >= bind_data.sample_size &&
+		    (bind_data.sample_size == 0 || key <= state.reservoir.front().key)) {
+			// Would be evicted immediately - skip materializing the row
+			continue;
+		}
+
+		VariableCopySampleRow row;
+		row.key = key;
+		row.values.reserve(col_count);
+		for (idx_t col_idx = 0; col_idx < col_count; col_idx++) {
+			row.values.push_back(input.data[col_idx].GetValue(row_idx));
+		}
+		AddToReservoir(state.reservoir, bind_data.sample_size, std::move(row));
+	}
+}
+
 // =============================================================================
 // Sink - Process incoming data chunks
 // =============================================================================
 
 void VariableCopyFunction::Sink(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
                                 LocalFunctionData &lstate, DataChunk &input) {
+	auto &bdata = bind_data.Cast<VariableCopyBindData>();
 	auto &state = gstate.Cast<VariableCopyGlobalState>();
 
+	// SAMPLE only touches the thread-local reservoir; it is merged in Combine
+	if (bdata.sample_size != DConstants::INVALID_INDEX) {
+		SinkSample(bdata, lstate.Cast<VariableCopyLocalState>(), input);
+		return;
+	}
+
 	// Thread-safe append to results
 	lock_guard<mutex> lock(state.lock);
-	state.results->Append(input);
+
+	// LIMIT: buffer rows up to the limit and drop everything after it.
+	// The COPY sink interface cannot stop the upstream pipeline, but dropped
+	// rows cost nothing beyond this check.
+	idx_t current_count = state.results->Count();
+	idx_t input_count = input.size();
+	if (bdata.limit != DConstants::INVALID_INDEX) {
+		if (current_count >= bdata.limit) {
+			return;
+		}
+		input_count = MinValue<idx_t>(input_count, bdata.limit - current_count);
+	}
+
+	// Enforce row limits before buffering, so an oversized result aborts the
+	// pipeline on the first offending chunk instead of after collecting everything
+	idx_t row_count = current_count + input_count;
+	CheckLimits(bdata, row_count, state.results->SizeInBytes());
+
+	if (input_count < input.size()) {
+		DataChunk head;
+		head.InitializeEmpty(input.GetTypes());
+		head.Reference(input);
+		head.SetCardinality(input_count);
+		state.results->Append(head);
+	} else {
+		state.results->Append(input);
+	}
+
+	// Byte size is only known after the chunk has been buffered
+	if (bdata.max_bytes != DConstants::INVALID_INDEX) {
+		CheckLimits(bdata, row_count, state.results->SizeInBytes());
+	}
 }
 
 // =============================================================================
-// Combine - Merge local state into global (no-op for us)
+// Combine - Merge local state into global
 // =============================================================================
 
 void VariableCopyFunction::Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
                                    LocalFunctionData &lstate) {
-	// No-op - we append directly to global state in Sink
+	// Only SAMPLE keeps thread-local rows - everything else appends to global state in Sink
+	auto &bdata = bind_data.Cast<VariableCopyBindData>();
+	if (bdata.sample_size == DConstants::INVALID_INDEX) {
+		return;
+	}
+
+	auto &state = gstate.Cast<VariableCopyGlobalState>();
+	auto &local = lstate.Cast<VariableCopyLocalState>();
+
+	lock_guard<mutex> lock(state.lock);
+	for (auto &row : local.reservoir) {
+		AddToReservoir(state.reservoir, bdata.sample_size, std::move(row));
+	}
+	local.reservoir.clear();
+}
+
+// =============================================================================
+// Convert Results to Columnar Value (LIST columns)
+// =============================================================================
+
+Value VariableCopyFunction::ConvertToColumns(ColumnDataCollection &results, const VariableCopyBindData &bind_data) {
+	// Build one typed list per column, scanning a single column at a time so that
+	// only that column's segments are touched and no per-row STRUCT is created
+	idx_t row_count = results.Count();
+	idx_t col_count = bind_data.column_types.size();
+
+	child_list_t<Value> struct_values;
+	for (idx_t col_idx = 0; col_idx < col_count; col_idx++) {
+		auto &col_type = bind_data.column_types[col_idx];
+
+		vector<Value> column_values;
+		column_values.reserve(row_count);
+
+		if (row_count > 0) {
+			vector<column_t> column_ids {col_idx};
+			DataChunk chunk;
+			chunk.Initialize(Allocator::DefaultAllocator(), {col_type});
+
+			ColumnDataScanState scan_state;
+			results.InitializeScan(scan_state, column_ids);
+			while (results.Scan(scan_state, chunk)) {
+				auto &vec = chunk.data[0];
+				for (idx_t row_idx = 0; row_idx < chunk.size(); row_idx++) {
+					column_values.push_back(vec.GetValue(row_idx));
+				}
+				chunk.Reset();
+			}
+		}
+
+		struct_values.push_back(
+		    make_pair(bind_data.column_names[col_idx], Value::LIST(col_type, std::move(column_values))));
+	}
+	return Value::STRUCT(std::move(struct_values));
+}
+
+// =============================================================================
+// Convert Results to MAP Value (LIST map)
+// =============================================================================
+
+Value VariableCopyFunction::ConvertToMap(ColumnDataCollection &results, const VariableCopyBindData &bind_data) {
+	idx_t col_count = bind_data.column_types.size();
+	idx_t key_col = bind_data.key_column;
+	auto &key_type = bind_data.column_types[key_col];
+
+	// Value is the single remaining column, or a struct of all remaining columns
+	child_list_t<LogicalType> value_children;
+	for (idx_t i = 0; i < col_count; i++) {
+		if (i != key_col) {
+			value_children.push_back(make_pair(bind_data.column_names[i], bind_data.column_types[i]));
+		}
+	}
+	bool struct_value = value_children.size() > 1;
+	auto value_type = struct_value ? LogicalType::STRUCT(value_children) : value_children[0].second;
+
+	vector<Value> keys;
+	vector<Value> values;
+	keys.reserve(results.Count());
+	values.reserve(results.Count());
+	value_set_t seen_keys;
+
+	DataChunk chunk;
+	chunk.Initialize(Allocator::DefaultAllocator(), bind_data.column_types);
+
+	ColumnDataScanState scan_state;
+	results.InitializeScan(scan_state);
+
+	while (results.Scan(scan_state, chunk)) {
+		for (idx_t row_idx = 0; row_idx < chunk.size(); row_idx++) {
+			auto key = chunk.data[key_col].GetValue(row_idx);
+			if (key.IsNull()) {
+				throw InvalidInputException("LIST map mode does not allow NULL keys (column '%s')",
+				                            bind_data.column_names[key_col]);
+			}
+			if (!seen_keys.insert(key).second) {
+				throw InvalidInputException("LIST map mode found duplicate key '%s' in column '%s'", key.ToString(),
+				                            bind_data.column_names[key_col]);
+			}
+
+			if (struct_value) {
+				child_list_t<Value> struct_values;
+				for (idx_t col_idx = 0; col_idx < col_count; col_idx++) {
+					if (col_idx != key_col) {
+						struct_values.push_back(
+						    make_pair(bind_data.column_names[col_idx], chunk.data[col_idx].GetValue(row_idx)));
+					}
+				}
+				values.push_back(Value::STRUCT(std::move(struct_values)));
+			} else {
+				values.push_back(chunk.data[key_col == 0 ? 1 : 0].GetValue(row_idx));
+			}
+			keys.push_back(std::move(key));
+		}
+		chunk.Reset();
+	}
+
+	return Value::MAP(key_type, value_type, std::move(keys), std::move(values));
 }
 
 // =============================================================================
@@ -121,6 +445,14 @@ Value VariableCopyFunction::ConvertToValue(ColumnDataCollection &results, const
 	idx_t row_count = results.Count();
 	idx_t col_count = bind_data.column_types.size();
 
+	// Columnar and map layouts have their own shape (including for empty results)
+	if (bind_data.list_mode == VariableCopyListMode::COLUMNS) {
+		return ConvertToColumns(results, bind_data);
+	}
+	if (bind_data.list_mode == VariableCopyListMode::MAP) {
+		return ConvertToMap(results, bind_data);
+	}
+
 	// Handle empty results
 	if (row_count == 0) {
 		// Return empty list with appropriate type
@@ -137,19 +469,7 @@ Value VariableCopyFunction::ConvertToValue(ColumnDataCollection &results, const
 		}
 	}
 
-	// Validate based on LIST mode
-	switch (bind_data.list_mode) {
-	case VariableCopyListMode::NONE:
-		if (row_count > 1) {
-			throw InvalidInputException("LIST none mode requires single row result, got %d rows", row_count);
-		}
-		break;
-	case VariableCopyListMode::SCALAR:
-		// Already validated in Bind
-		break;
-	default:
-		break;
-	}
+	// Row limits (including LIST none) are enforced in Sink; SCALAR is validated in Bind
 
 	// Collect all values from results
 	vector<vector<Value>> all_values(col_count);
@@ -252,6 +572,59 @@ Value VariableCopyFunction::ConvertToValue(ColumnDataCollection &results, const
 	}
 }
 
+// =============================================================================
+// Append Support
+// =============================================================================
+
+Value VariableCopyFunction::ConvertToAppendValue(ColumnDataCollection &results,
+                                                 const VariableCopyBindData &bind_data) {
+	// Always produce the list shape, even for a single row, so it can be concatenated
+	if (bind_data.list_mode == VariableCopyListMode::COLUMNS) {
+		return ConvertToColumns(results, bind_data);
+	}
+
+	bool as_values = bind_data.column_types.size() == 1 && bind_data.list_mode != VariableCopyListMode::ROWS;
+	VariableCopyBindData list_bind(bind_data.variable_name,
+	                               as_values ? VariableCopyListMode::SCALAR : VariableCopyListMode::ROWS,
+	                               bind_data.column_names, bind_data.column_types);
+	auto value = ConvertToValue(results, list_bind);
+	if (as_values && results.Count() == 1) {
+		// SCALAR mode unwraps a single row - wrap it back into a list
+		return Value::LIST(bind_data.column_types[0], {value});
+	}
+	return value;
+}
+
+Value VariableCopyFunction::AppendToExisting(const Value &existing, const Value &appended,
+                                             const VariableCopyBindData &bind_data) {
+	if (existing.type() != appended.type()) {
+		throw InvalidInputException("Cannot APPEND to variable '%s': existing type %s does not match appended type %s",
+		                            bind_data.variable_name, existing.type().ToString(), appended.type().ToString());
+	}
+
+	if (bind_data.list_mode == VariableCopyListMode::COLUMNS) {
+		// Extend each field list of the struct
+		auto &existing_fields = StructValue::GetChildren(existing);
+		auto &appended_fields = StructValue::GetChildren(appended);
+		child_list_t<Value> struct_values;
+		for (idx_t i = 0; i < existing_fields.size(); i++) {
+			auto values = ListValue::GetChildren(existing_fields[i]);
+			auto &new_values = ListValue::GetChildren(appended_fields[i]);
+			values.insert(values.end(), new_values.begin(), new_values.end());
+			struct_values.push_back(make_pair(bind_data.column_names[i],
+			                                  Value::LIST(bind_data.column_types[i], std::move(values))));
+		}
+		return Value::STRUCT(std::move(struct_values));
+	}
+
+	// A LIST value's children are immutable and shared between copies, so the
+	// existing elements are copied once into the new list (O(existing size))
+	auto values = ListValue::GetChildren(existing);
+	auto &new_values = ListValue::GetChildren(appended);
+	values.insert(values.end(), new_values.begin(), new_values.end());
+	return Value::LIST(ListType::GetChildType(existing.type()), std::move(values));
+}
+
 // =============================================================================
 // Finalize - Store result in variable
 // =============================================================================
@@ -260,12 +633,52 @@ void VariableCopyFunction::Finalize(ClientContext &context, FunctionData &bind_d
 	auto &bdata = bind_data.Cast<VariableCopyBindData>();
 	auto &state = gstate.Cast<VariableCopyGlobalState>();
 
+	// SAMPLE: move the merged reservoir into the results collection
+	if (bdata.sample_size != DConstants::INVALID_INDEX) {
+		DataChunk chunk;
+		chunk.Initialize(Allocator::DefaultAllocator(), bdata.column_types);
+		for (auto &row : state.reservoir) {
+			for (idx_t col_idx = 0; col_idx < row.values.size(); col_idx++) {
+				chunk.SetValue(col_idx, chunk.size(), row.values[col_idx]);
+			}
+			chunk.SetCardinality(chunk.size() + 1);
+			if (chunk.size() == STANDARD_VECTOR_SIZE) {
+				state.results->Append(chunk);
+				chunk.Reset();
+			}
+		}
+		if (chunk.size() > 0) {
+			state.results->Append(chunk);
+		}
+		state.reservoir.clear();
+		CheckLimits(bdata, state.results->Count(), state.results->SizeInBytes());
+	}
+
 	// Convert collected results to a Value
-	Value result = ConvertToValue(*state.results, bdata);
+	Value result;
+	if (bdata.native) {
+		auto blob = ScalarfsNativeFormat::Serialize(*state.results, bdata.column_names);
+		result = Value::BLOB(const_data_ptr_cast(blob.data()), blob.size());
+	} else if (bdata.append) {
+		auto &config = ClientConfig::GetConfig(context);
+		Value existing;
+		bool has_existing = config.GetUserVariable(bdata.variable_name, existing) && !existing.IsNull();
+		if (has_existing && state.results->Count() == 0) {
+			// Nothing to append - leave the existing value untouched
+			return;
+		}
+		result = ConvertToAppendValue(*state.results, bdata);
+		if (has_existing) {
+			result = AppendToExisting(existing, result, bdata);
+		}
+	} else {
+		result = ConvertToValue(*state.results, bdata);
+	}
 
 	// Store in variable
 	auto &config = ClientConfig::GetConfig(context);
 	config.SetUserVariable(bdata.variable_name, result);
+	VariableNameIndex::NotifySet(context, bdata.variable_name);
 }
 
 // =============================================================================
@@ -285,6 +698,20 @@ void VariableCopyFunction::Register(ExtensionLoader &loader) {
 	info.extension = "scalarfs";
 
 	loader.RegisterFunction(info);
+
+	// FORMAT scalarfs_native - same sink, binary chunk serialization on finalize
+	CopyFunction native_info("scalarfs_native");
+
+	native_info.copy_to_bind = NativeBind;
+	native_info.copy_to_initialize_global = InitializeGlobal;
+	native_info.copy_to_initialize_local = InitializeLocal;
+	native_info.copy_to_sink = Sink;
+	native_info.copy_to_combine = Combine;
+	native_info.copy_to_finalize = Finalize;
+
+	native_info.extension = "scalarfs";
+
+	loader.RegisterFunction(native_info);
 }
 
 } // namespace duckdb
@@ -1,10 +1,10 @@
 #include "variable_filesystem.hpp"
+#include "variable_name_index.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/common/types/value.hpp"
-#include "duckdb/function/scalar/string_common.hpp"
 #include "duckdb/main/client_config.hpp"
 
 namespace duckdb {
@@ -47,6 +47,7 @@ void VariableWriteHandle::Close() {
 	} else {
 		config.SetUserVariable(var_name, Value(buffer));
 	}
+	VariableNameIndex::NotifySet(context, var_name);
 }
 
 // =============================================================================
@@ -134,10 +135,10 @@ vector<OpenFileInfo> VariableFileSystem::Glob(const string &path, FileOpener *op
 	//   read_json('variable:config_*')     -> matches config_dev, config_prod, etc.
 	//   read_csv('variable:data_2024_??')  -> matches data_2024_01, data_2024_12, etc.
 	//
-	// Pattern syntax (standard glob):
-	//   *  - matches any sequence of characters
-	//   ?  - matches any single character
-	//   [abc] - matches any character in the set (not yet supported)
+	// Pattern syntax (standard glob, see VariableGlobPattern):
+	//   *      - matches any sequence of characters
+	//   ?      - matches any single character
+	//   [abc]  - matches any character in the set ([a-z] ranges, [!abc] negation)
 	//
 	// If no glob characters are present, returns the path as-is (standard behavior).
 
@@ -161,30 +162,22 @@ vector<OpenFileInfo> VariableFileSystem::Glob(const string &path, FileOpener *op
 		return {OpenFileInfo(path)};
 	}
 
-	// Iterate over all user variables and match against the pattern
+	// Look up matching variable names in the sorted name index - only names sharing
+	// the pattern's literal prefix are examined, and matches come out sorted
 	auto &config = ClientConfig::GetConfig(*context);
 	vector<OpenFileInfo> result;
 
-	for (const auto &entry : config.user_variables) {
-		const string &var_name = entry.first;
-		const Value &var_value = entry.second;
-
+	for (const auto &var_name : VariableNameIndex::Get(*context).Match(*context, pattern)) {
 		// Skip NULL variables (they can't be read anyway)
-		if (var_value.IsNull()) {
+		Value var_value;
+		if (!config.GetUserVariable(var_name, var_value) || var_value.IsNull()) {
 			continue;
 		}
 
-		// Match the variable name against the glob pattern
-		if (duckdb::Glob(var_name.c_str(), var_name.size(), pattern.c_str(), pattern.size())) {
-			// Construct the full variable: path for this match
-			result.push_back(OpenFileInfo("variable:" + var_name));
-		}
+		// Construct the full variable: path for this match
+		result.push_back(OpenFileInfo("variable:" + var_name));
 	}
 
-	// Sort results for deterministic ordering
-	std::sort(result.begin(), result.end(),
-	          [](const OpenFileInfo &a, const OpenFileInfo &b) { return a.path < b.path; });
-
 	return result;
 }
 
@@ -311,6 +304,7 @@ void VariableFileSystem::RemoveFile(const string &filename, optional_ptr<FileOpe
 		string var_name = ExtractVariableName(filename);
 		auto &config = ClientConfig::GetConfig(*context);
 		config.ResetUserVariable(var_name);
+		VariableNameIndex::NotifyReset(*context, var_name);
 	}
 }
 
@@ -355,9 +349,11 @@ void VariableFileSystem::MoveFile(const string &source, const string &target, op
 
 	// Write to target variable
 	config.SetUserVariable(tgt_var, src_value);
+	VariableNameIndex::NotifySet(*context, tgt_var);
 
 	// Remove source variable
 	config.ResetUserVariable(src_var);
+	VariableNameIndex::NotifyReset(*context, src_var);
 }
 
 } // namespace duckdb
@@ -0,0 +1,171 @@
+#include "variable_glob_pattern.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+VariableGlobPattern::VariableGlobPattern(const string &pattern) {
+	idx_t i = 0;
+	auto append_literal = [&](char c) {
+		if (tokens.empty() || tokens.back().type != TokenType::LITERAL) {
+			tokens.push_back(Token {TokenType::LITERAL, string(), {}});
+		}
+		tokens.back().literal += c;
+	};
+
+	while (i < pattern.size()) {
+		char c = pattern[i];
+		if (c == '*') {
+			// Consecutive stars are equivalent to one
+			if (tokens.empty() || tokens.back().type != TokenType::STAR) {
+				tokens.push_back(Token {TokenType::STAR, string(), {}});
+			}
+			i++;
+		} else if (c == '?') {
+			tokens.push_back(Token {TokenType::ANY, string(), {}});
+			i++;
+		} else if (c == '\\' && i + 1 < pattern.size()) {
+			append_literal(pattern[i + 1]);
+			i += 2;
+		} else if (c == '[') {
+			// Find the closing bracket - a ']' in first position belongs to the set
+			idx_t j = i + 1;
+			bool negate = false;
+			if (j < pattern.size() && (pattern[j] == '!' || pattern[j] == '^')) {
+				negate = true;
+				j++;
+			}
+			idx_t set_start = j;
+			if (j < pattern.size() && pattern[j] == ']') {
+				j++;
+			}
+			while (j < pattern.size() && pattern[j] != ']') {
+				j++;
+			}
+			if (j >= pattern.size()) {
+				// Unterminated - treat '[' as a literal
+				append_literal(c);
+				i++;
+				continue;
+			}
+
+			Token token {TokenType::CLASS, string(), {}};
+			for (idx_t k = set_start; k < j; k++) {
+				auto lo = static_cast<unsigned char>(pattern[k]);
+				if (k + 2 < j && pattern[k + 1] == '-') {
+					auto hi = static_cast<unsigned char>(pattern[k + 2]);
+					for (idx_t ch = lo; ch <= hi; ch++) {
+						token.chars.set(ch);
+					}
+					k += 2;
+				} else {
+					token.chars.set(lo);
+				}
+			}
+			if (negate) {
+				token.chars.flip();
+			}
+			tokens.push_back(std::move(token));
+			i = j + 1;
+		} else {
+			append_literal(c);
+			i++;
+		}
+	}
+
+	for (auto &token : tokens) {
+		if (token.type == TokenType::STAR) {
+			has_star = true;
+		} else {
+			min_length += token.type == TokenType::LITERAL ? token.literal.size() : 1;
+		}
+	}
+
+	// Peel off the leading and trailing literal runs - they are checked with memcmp
+	token_begin = 0;
+	token_end = tokens.size();
+	if (token_begin < token_end && tokens[token_begin].type == TokenType::LITERAL) {
+		prefix = tokens[token_begin].literal;
+		token_begin++;
+	}
+	if (token_begin < token_end && tokens[token_end - 1].type == TokenType::LITERAL) {
+		suffix = tokens[token_end - 1].literal;
+		token_end--;
+	}
+}
+
+bool VariableGlobPattern::Matches(const string &name) const {
+	if (has_star ? name.size() < min_length : name.size() != min_length) {
+		return false;
+	}
+	if (!prefix.empty() && memcmp(name.data(), prefix.data(), prefix.size()) != 0) {
+		return false;
+	}
+	if (!suffix.empty() &&
+	    memcmp(name.data() + name.size() - suffix.size(), suffix.data(), suffix.size()) != 0) {
+		return false;
+	}
+	return MatchTokens(name.data(), prefix.size(), name.size() - suffix.size());
+}
+
+bool VariableGlobPattern::MatchToken(const Token &token, const char *name, idx_t &pos, idx_t end) const {
+	switch (token.type) {
+	case TokenType::LITERAL:
+		if (end - pos < token.literal.size() || memcmp(name + pos, token.literal.data(), token.literal.size()) != 0) {
+			return false;
+		}
+		pos += token.literal.size();
+		return true;
+	case TokenType::ANY:
+		if (pos >= end) {
+			return false;
+		}
+		pos++;
+		return true;
+	case TokenType::CLASS:
+		if (pos >= end || !token.chars.test(static_cast<unsigned char>(name[pos]))) {
+			return false;
+		}
+		pos++;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool VariableGlobPattern::MatchTokens(const char *name, idx_t start, idx_t end) const {
+	// Iterative matching with single-star backtracking: on a mismatch, resume
+	// after the most recent star with that star consuming one more character.
+	// Each star only ever advances, so this runs in O(tokens * name) worst case.
+	idx_t pos = start;
+	idx_t t = token_begin;
+	idx_t star_token = DConstants::INVALID_INDEX;
+	idx_t star_pos = 0;
+
+	while (true) {
+		if (t < token_end && tokens[t].type == TokenType::STAR) {
+			star_token = t++;
+			star_pos = pos;
+			continue;
+		}
+		if (t == token_end) {
+			if (pos == end) {
+				return true;
+			}
+		} else {
+			idx_t next = pos;
+			if (MatchToken(tokens[t], name, next, end)) {
+				pos = next;
+				t++;
+				continue;
+			}
+		}
+		if (star_token == DConstants::INVALID_INDEX || star_pos >= end) {
+			return false;
+		}
+		star_pos++;
+		pos = star_pos;
+		t = star_token + 1;
+	}
+}
+
+} // namespace duckdb
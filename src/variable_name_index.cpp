@@ -0,0 +1,92 @@
+#include "variable_name_index.hpp"
+#include "variable_glob_pattern.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_config.hpp"
+#include "duckdb/main/prepared_statement_data.hpp"
+
+namespace duckdb {
+
+static constexpr const char *VARIABLE_NAME_INDEX_KEY = "scalarfs_variable_name_index";
+
+VariableNameIndex &VariableNameIndex::Get(ClientContext &context) {
+	return *context.registered_state->GetOrCreate<VariableNameIndex>(VARIABLE_NAME_INDEX_KEY);
+}
+
+void VariableNameIndex::NotifySet(ClientContext &context, const string &name) {
+	auto index = context.registered_state->Get<VariableNameIndex>(VARIABLE_NAME_INDEX_KEY);
+	if (!index) {
+		// Not created yet - it is built from the variable map on first use
+		return;
+	}
+	std::lock_guard<std::mutex> guard(index->lock);
+	index->names.insert(name);
+}
+
+void VariableNameIndex::NotifyReset(ClientContext &context, const string &name) {
+	auto index = context.registered_state->Get<VariableNameIndex>(VARIABLE_NAME_INDEX_KEY);
+	if (!index) {
+		return;
+	}
+	std::lock_guard<std::mutex> guard(index->lock);
+	index->names.erase(name);
+}
+
+RebindQueryInfo VariableNameIndex::OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+                                                     PreparedStatementMode mode) {
+	// SET VARIABLE / RESET VARIABLE bypass scalarfs - rebuild on the next lookup
+	if (prepared_statement.statement_type == StatementType::SET_STATEMENT) {
+		std::lock_guard<std::mutex> guard(lock);
+		dirty = true;
+	}
+	return RebindQueryInfo::DO_NOT_REBIND;
+}
+
+RebindQueryInfo VariableNameIndex::OnExecutePrepared(ClientContext &context, PreparedStatementCallbackInfo &info,
+                                                     RebindQueryInfo current_rebind) {
+	// A prepared SET / RESET VARIABLE runs again through EXECUTE without being
+	// prepared again - and a reset plus a set keep the variable count equal
+	if (info.prepared_statement.statement_type == StatementType::SET_STATEMENT) {
+		std::lock_guard<std::mutex> guard(lock);
+		dirty = true;
+	}
+	return current_rebind;
+}
+
+void VariableNameIndex::Rebuild(ClientContext &context) {
+	auto &config = ClientConfig::GetConfig(context);
+	names.clear();
+	for (const auto &entry : config.user_variables) {
+		names.insert(entry.first);
+	}
+	dirty = false;
+}
+
+vector<string> VariableNameIndex::Match(ClientContext &context, const string &pattern) {
+	auto &config = ClientConfig::GetConfig(context);
+
+	std::lock_guard<std::mutex> guard(lock);
+	if (dirty || names.size() != config.user_variables.size()) {
+		Rebuild(context);
+	}
+
+	// Compile once, then match every candidate with the same program. All names
+	// sharing the pattern's literal prefix form one contiguous range.
+	VariableGlobPattern glob(pattern);
+	auto &prefix = glob.GetPrefix();
+	vector<string> result;
+	for (auto it = names.lower_bound(prefix); it != names.end(); ++it) {
+		auto &name = *it;
+		if (!StringUtil::StartsWith(name, prefix)) {
+			break;
+		}
+		if (config.user_variables.find(name) == config.user_variables.end()) {
+			continue;
+		}
+		if (glob.Matches(name)) {
+			result.push_back(name);
+		}
+	}
+	return result;
+}
+
+} // namespace duckdb